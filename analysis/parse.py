@@ -24,6 +24,24 @@ def parse_lru(segment):
 
     return lru
 
+def parse_customers(data, start):
+    """ Monitored customer block: count, then id, age, bytes, objects"""
+    customers = {}
+    for i in range(int(data[start])):
+        cust = data[start + 1 + 4 * i:start + 5 + 4 * i]
+        customers[cust[0]] = {
+            "oldest_file_age": float(cust[1]),
+            "bytes": int(cust[2]),
+            "objects": int(cust[3]),
+            }
+    return customers
+
+def parse_lru_customers(segment):
+    """ Parser for the LRU variants that also report monitored customers"""
+    lru = parse_lru(segment)
+    lru["customers"] = parse_customers(segment.split(), 3)
+    return lru
+
 def parse_2hc(segment):
     """ Parser for 2hc periodic output"""
     second_hit = {}
@@ -33,11 +51,252 @@ def parse_2hc(segment):
 
     return second_hit
 
+def parse_s4lru(segment):
+    """ Parser for S4LRU periodic output"""
+    s4lru = {}
+
+    data = segment.split()
+    s4lru["size"] = int(data[1])
+
+    # Then six counters per segment, bottom (probationary) segment first
+    fields = ["bytes", "capacity", "hits", "hit_bytes", "promoted", "demoted"]
+    s4lru["segments"] = []
+    for i in range(int(data[2])):
+        values = data[3 + i * len(fields):3 + (i + 1) * len(fields)]
+        s4lru["segments"].append(dict(zip(fields, [int(x) for x in values])))
+
+    return s4lru
+
+def parse_fifo_age(segment):
+    """ Parser for FIFO with TTL expiry periodic output"""
+    fifo_age = parse_lru(segment)
+
+    data = segment.split()
+    fifo_age["expired"] = int(data[3])
+    fifo_age["expired_bytes"] = int(data[4])
+    fifo_age["evicted"] = int(data[5])
+    fifo_age["evicted_bytes"] = int(data[6])
+    fifo_age["customers"] = parse_customers(data, 7)
+
+    return fifo_age
+
+def parse_sampled(segment):
+    """ Parser for sampled eviction periodic output"""
+    sampled = {}
+
+    data = segment.split()
+    sampled["size"] = int(data[1])
+    sampled["items"] = int(data[2])
+    sampled["samples"] = int(data[3])
+    sampled["scorer"] = data[4]
+    sampled["evicted"] = int(data[5])
+    sampled["evicted_bytes"] = int(data[6])
+    sampled["avg_victim_score"] = float(data[7])
+
+    return sampled
+
+def parse_s3fifo(segment):
+    """ Parser for S3-FIFO eviction periodic output"""
+    s3fifo = {}
+
+    data = segment.split()
+    fields = ["size", "small_bytes", "main_bytes", "small_items", "main_items",
+              "ghost_items", "small_hits", "main_hits", "promoted", "reinserted",
+              "ghost_hits", "evicted_small", "evicted_main"]
+    for i, field in enumerate(fields):
+        s3fifo[field] = int(data[1 + i])
+
+    return s3fifo
+
+def parse_clock(segment):
+    """ Parser for CLOCK and SIEVE eviction periodic output"""
+    clock = {}
+
+    data = segment.split()
+    fields = ["size", "items", "slots", "max_counter", "evicted",
+              "evicted_bytes", "hand_steps", "compactions"]
+    for i, field in enumerate(fields):
+        clock[field] = int(data[1 + i])
+
+    return clock
+
+def parse_gdsf(segment):
+    """ Parser for GreedyDual-Size-Frequency eviction periodic output"""
+    gdsf = {}
+
+    data = segment.split()
+    gdsf["size"] = int(data[1])
+    gdsf["items"] = int(data[2])
+    gdsf["cost"] = data[3]
+    gdsf["clock"] = float(data[4])
+    gdsf["evicted"] = int(data[5])
+    gdsf["evicted_bytes"] = int(data[6])
+    gdsf["evicted_cost"] = float(data[7])
+    gdsf["hit_bytes"] = int(data[8])
+    gdsf["saved_cost"] = float(data[9])
+
+    return gdsf
+
+def parse_lhd(segment):
+    """ Parser for Least Hit Density eviction periodic output"""
+    lhd = {}
+
+    data = segment.split()
+    lhd["size"] = int(data[1])
+    lhd["items"] = int(data[2])
+    lhd["samples"] = int(data[3])
+    lhd["age_shift"] = int(data[4])
+    lhd["reconfigurations"] = int(data[5])
+    lhd["evicted"] = int(data[6])
+    lhd["evicted_bytes"] = int(data[7])
+    lhd["avg_victim_density"] = float(data[8])
+
+    return lhd
+
+def parse_arc(segment):
+    """ Parser for ARC and CAR eviction periodic output"""
+    arc = {}
+
+    data = segment.split()
+    fields = ["size", "p", "t1_bytes", "t2_bytes", "b1_bytes", "b2_bytes",
+              "t1_items", "t2_items", "b1_items", "b2_items",
+              "t1_hits", "t2_hits", "b1_hits", "b2_hits", "evicted"]
+    for i, field in enumerate(fields):
+        arc[field] = int(data[1 + i])
+
+    return arc
+
+def parse_lirs(segment):
+    """ Parser for LIRS eviction periodic output"""
+    lirs = {}
+
+    data = segment.split()
+    fields = ["size", "lir_bytes", "hir_bytes", "lir_items", "hir_items",
+              "nonresident_items", "stack_items", "lir_hits", "hir_hits",
+              "nonresident_hits", "demoted", "evicted"]
+    for i, field in enumerate(fields):
+        lirs[field] = int(data[1 + i])
+
+    return lirs
+
+def parse_belady(segment):
+    """ Parser for Belady (offline) eviction periodic output"""
+    belady = {}
+
+    data = segment.split()
+    fields = ["size", "items", "evicted", "evicted_bytes", "evicted_never",
+              "bypassed"]
+    for i, field in enumerate(fields):
+        belady[field] = int(data[1 + i])
+
+    return belady
+
+def parse_lrb(segment):
+    """ Parser for learned (LRB) eviction periodic output"""
+    lrb = {}
+
+    data = segment.split()
+    fields = ["size", "items", "window_objects", "evicted", "features",
+              "feature_ns", "inferences", "inference_ns", "trainings"]
+    for i, field in enumerate(fields):
+        lrb[field] = int(data[1 + i])
+    lrb["train_ms"] = float(data[10])
+    lrb["train_rmse"] = float(data[11])
+    lrb["trees"] = int(data[12])
+    lrb["batch"] = int(data[13])
+
+    return lrb
+
+def parse_learned(segment):
+    """ Parser for learned admission periodic output"""
+    learned = {}
+
+    data = segment.split()
+    fields = ["admitted", "rejected", "admitted_hit", "admitted_wasted",
+              "rejected_back", "rejected_gone"]
+    for i, field in enumerate(fields):
+        learned[field] = int(data[1 + i])
+    learned["logloss"] = float(data[7])
+    learned["keys"] = int(data[8])
+    learned["horizon"] = int(data[9])
+    learned["check_ns"] = int(data[10])
+
+    return learned
+
+def parse_cuckoo(segment):
+    """ Parser for cuckoo filter admission periodic output"""
+    cuckoo = {}
+
+    data = segment.split()
+    cuckoo["fill_perc"] = float(data[1])
+    cuckoo["fpr"] = float(data[2])
+    cuckoo["occupied"] = int(data[3])
+    cuckoo["admitted"] = int(data[4])
+    cuckoo["rejected"] = int(data[5])
+    cuckoo["expired"] = int(data[6])
+    cuckoo["dropped"] = int(data[7])
+
+    return cuckoo
+
+def parse_tinylfu(segment):
+    """ Parser for TinyLFU admission periodic output"""
+    tinylfu = {}
+
+    data = segment.split()
+    tinylfu["admitted"] = int(data[1])
+    tinylfu["rejected"] = int(data[2])
+    tinylfu["free_admits"] = int(data[3])
+    tinylfu["resets"] = int(data[4])
+    tinylfu["memory_KB"] = int(data[5])
+
+    return tinylfu
+
+def parse_combinator(segment):
+    """ Parser for admission combinator periodic output"""
+    combinator = {}
+
+    data = segment.split()
+    combinator["admitted"] = int(data[1])
+    combinator["rejected"] = int(data[2])
+    # accepted/rejected by each branch it asked
+    counts = [int(x) for x in data[3:]]
+    combinator["branches"] = list(zip(counts[0::2], counts[1::2]))
+
+    return combinator
+
+def parse_generic(segment):
+    """ Fallback for policies without a parser, keeps the raw fields"""
+    return {"fields": segment.split()[1:]}
+
 # A dictionary that holds all the different parsing functions
 POLICY_FUNC = {
     "lru": parse_lru,
     "2hc": parse_2hc,
     "2hc_rot": parse_2hc, #NOTE: uses same func
+    "s4lru": parse_s4lru,
+    "fifo_age": parse_fifo_age,
+    "size_lru": parse_lru_customers,
+    "cost_lru": parse_lru_customers,
+    "sampled": parse_sampled,
+    "s3fifo": parse_s3fifo,
+    "clock": parse_clock,
+    "sieve": parse_clock, #NOTE: uses same func
+    "gdsf": parse_gdsf,
+    "lhd": parse_lhd,
+    "arc": parse_arc,
+    "car": parse_arc, #NOTE: uses same func
+    "lirs": parse_lirs,
+    "belady": parse_belady,
+    "belady_size": parse_belady, #NOTE: uses same func
+    "lrb": parse_lrb,
+    "learned": parse_learned,
+    "cuckoo": parse_cuckoo,
+    "tinylfu": parse_tinylfu,
+    "and": parse_combinator,
+    "or": parse_combinator,
+    "not": parse_combinator,
+    "size_gate": parse_combinator,
+    "customer_gate": parse_combinator,
     }
 ###########################
 
@@ -96,11 +355,19 @@ def proc_cache_chunk(key, chunk, index):
 
         # Ok now read from your admission set
         admit_name = segments[1].split()[0]
-        data_dict[admit_name] = POLICY_FUNC[admit_name](segments[1])
-
-        # Next the eviction set
-        evict_name = segments[2].split()[0]
-        data_dict[evict_name] = POLICY_FUNC[evict_name](segments[2])
+        data_dict[admit_name] = POLICY_FUNC.get(admit_name, parse_generic)(segments[1])
+
+        # Combinators are followed by their branches, depth first
+        branches = []
+        for segment in segments[2:-1]:
+            branch_name = segment.split()[0]
+            branches.append((branch_name, POLICY_FUNC.get(branch_name, parse_generic)(segment)))
+        if branches:
+            data_dict["admission_branches"] = branches
+
+        # Next the eviction set, always last
+        evict_name = segments[-1].split()[0]
+        data_dict[evict_name] = POLICY_FUNC.get(evict_name, parse_generic)(segments[-1])
 
     # here the key out will be the index less one, since generic is 0
     return (index - 1, data_dict)
@@ -0,0 +1,178 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * ARC and CAR Cache Eviction Policies, in bytes
+ *
+ * Both split the cache into T1 (seen once recently) and T2 (seen at least
+ * twice) and remember what they evicted from each in the ghost lists B1 and
+ * B2. A miss found in B1 means T1 was too small, so its byte target p grows
+ * by the object size (times |B2|/|B1| if B2 is bigger); a miss found in B2
+ * shrinks p. Evictions come from T1 while it holds more than p bytes.
+ *
+ * ARC keeps T1 and T2 as LRU lists, a hit moves the entry to the MRU end of
+ * T2. CAR keeps them as CLOCKs on ring buffers, a hit only sets a reference
+ * bit and the hand moves referenced T1 entries on to T2.
+ *
+ * Ghosts are 64 bit key fingerprints with the object size. As in ARC the
+ * B1 + T1 bytes stay under the capacity and all four lists under twice the
+ * capacity, and there are never more ghosts than cached objects. The rings
+ * behind the ghost lists are compacted before they hold twice that.
+ */
+
+#ifndef ARC_EVICTION_H_
+#define ARC_EVICTION_H_
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#include "hashfunc.h"
+#include "ring_buffer.h"
+
+#define ARC_HASH_SEED 0xa4c0a4c0
+#define ARC_GHOST_SLACK 64 // stale ring copies allowed on top of 2 x the ghosts
+
+struct ArcEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    unsigned long data;
+    unsigned long timestamp;
+    unsigned long count; // keep track of request count
+    bool in_t2;
+    bool referenced; // CAR only
+    ArcEvictionEntry* prev; // ARC only
+    ArcEvictionEntry* next;
+};
+
+struct ArcGhost
+{
+    uint64_t fingerprint;
+    unsigned long long seq; // matches the index while this is the live copy
+};
+
+/* LRU order ghost list of fingerprints, oldest first */
+class ArcGhostList {
+    private:
+        struct Info {
+            unsigned long long seq;
+            unsigned long data;
+        };
+        RingBuffer<ArcGhost> order;
+        std::unordered_map<uint64_t, Info> index;
+        unsigned long long seq;
+        unsigned long long bytes;
+
+        void compact();
+
+    public:
+        ArcGhostList() : seq(0), bytes(0) {}
+
+        inline size_t size() const                  { return index.size(); }
+        inline unsigned long long get_bytes() const { return bytes; }
+
+        void push(uint64_t fingerprint, unsigned long data);
+        /* True (and forgets it) if fingerprint is a ghost here */
+        bool take(uint64_t fingerprint);
+        /* Forgets the oldest ghost, false if there is none */
+        bool pop_oldest();
+};
+
+/* What ARC and CAR share: the ghosts, p and the reporting */
+class AdaptiveEviction : public CacheEviction {
+    protected:
+        const EmConfItems* sci;
+
+        std::unordered_map<std::string, ArcEvictionEntry*> _mapping;
+        ArcGhostList b1;
+        ArcGhostList b2;
+        double p; // target bytes of T1
+
+        unsigned long long t1_bytes;
+        unsigned long long t2_bytes;
+        unsigned long long t1_items;
+        unsigned long long t2_items;
+
+        unsigned long long current_size;
+        unsigned long long total_capacity;
+        std::string cache_id; // k=kernel, h=hdd
+
+        // Reset every periodic_output
+        unsigned long t1_hits;
+        unsigned long t2_hits;
+        unsigned long b1_hits;
+        unsigned long b2_hits;
+        unsigned long evicted;
+
+        AdaptiveEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+
+        static inline uint64_t fingerprint(const std::string& key) {
+            return wyhash(key.data(), key.size(), ARC_HASH_SEED);
+        }
+        ArcEvictionEntry* new_entry(const std::string& key, unsigned long data,
+                                    unsigned long timestamp, const std::string& customer_id);
+        /* Looks the missed key up in the ghosts and moves p, true if it goes to T2 */
+        bool adapt(const std::string& key, unsigned long data, bool& from_b2);
+        /* Drops T1's or T2's entry, leaving its ghost behind */
+        void evict(ArcEvictionEntry* node);
+        void trim_ghosts();
+
+    public:
+        ~AdaptiveEviction();
+
+        void hourly_purging(unsigned long timestamp);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+class ArcEviction : public AdaptiveEviction {
+    private:
+        ArcEvictionEntry* t1_head; // MRU end, sentinel
+        ArcEvictionEntry* t1_tail; // LRU end, sentinel
+        ArcEvictionEntry* t2_head;
+        ArcEvictionEntry* t2_tail;
+        bool replace_from_b2; // the miss being served was a B2 ghost
+
+        void detach(ArcEvictionEntry* node);
+        void attach(ArcEvictionEntry* node, ArcEvictionEntry* head);
+
+    public:
+        ArcEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+        ~ArcEviction();
+
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+
+        /*
+         * evicts the LRU of T1 if it is over p, else the LRU of T2
+         */
+        bool purge_regular();
+};
+
+class CarEviction : public AdaptiveEviction {
+    private:
+        RingBuffer<ArcEvictionEntry*> t1; // hand at the front
+        RingBuffer<ArcEvictionEntry*> t2;
+
+    public:
+        CarEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+
+        /*
+         * sweeps T1 if it is over p, else T2, and evicts the first entry
+         * without its reference bit
+         */
+        bool purge_regular();
+};
+
+#endif /* ARC_EVICTION_H_ */
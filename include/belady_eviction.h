@@ -0,0 +1,140 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Belady (offline) Cache Eviction Policies, in bytes
+ *
+ * Both need the next access of every request, set by a NextAccessOracle, so
+ * they only run offline and bound what the online policies could get. Run
+ * them behind NullAdmission: a new object that ranks worst is evicted by its
+ * own put, which is the same as not admitting it.
+ *
+ * BeladyEviction evicts the entry whose next access is furthest away, from
+ * an indexed 4-ary heap. That is OPT for object hits when all objects have
+ * the same size. With variable sizes it values every cached byte the same,
+ * so it is the one to compare byte hit ratios against.
+ *
+ * BeladySizeEviction evicts the entry with the largest size times distance
+ * to its next access out of BELADY_SIZE_SAMPLES random ones (relaxed
+ * Belady). Those take the most cache space per hit, so this is the object
+ * hit ratio one. Distances shrink as requests go by, which rules out a heap.
+ * Entries never requested again go first, before any sampling. Offline
+ * there is no point in saving on samples, the online eviction_samples of 16
+ * loses a sixth of the hits.
+ */
+
+#ifndef BELADY_EVICTION_H_
+#define BELADY_EVICTION_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "indexed_heap.h"
+
+#define BELADY_SIZE_SAMPLES 256
+
+struct BeladyEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    unsigned long data;
+    unsigned long timestamp;
+    unsigned long count; // keep track of request count
+    unsigned long long next_access; // request index, NEXT_ACCESS_NEVER if none
+    size_t heap_index; // BeladyEviction
+    size_t slot; // BeladySizeEviction, in entries or never_again
+};
+
+/* Furthest next access on top, the largest first among ties */
+struct BeladyLess {
+    inline bool operator()(const BeladyEvictionEntry* a, const BeladyEvictionEntry* b) const {
+        if (a->next_access != b->next_access) {
+            return a->next_access > b->next_access;
+        }
+        return a->data > b->data;
+    }
+};
+
+/* What both share: the next access of the current request and the reporting */
+class OfflineEviction : public CacheEviction {
+    protected:
+        const EmConfItems* sci;
+
+        std::unordered_map<std::string, BeladyEvictionEntry*> _mapping;
+        unsigned long long now; // request being served
+        unsigned long long upcoming; // its next access
+        BeladyEvictionEntry* incoming; // being put, to count bypasses
+
+        unsigned long long current_size;
+        unsigned long long total_capacity;
+        std::string cache_id; // k=kernel, h=hdd
+
+        // Reset every periodic_output
+        unsigned long evicted;
+        unsigned long long evicted_bytes;
+        unsigned long evicted_never; // not requested again, no loss
+        unsigned long bypassed; // evicted by their own put
+
+        OfflineEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+
+        BeladyEvictionEntry* new_entry(const std::string& key, unsigned long data,
+                                       unsigned long timestamp, const std::string& customer_id);
+        /* Accounts for and frees an entry already out of the ranking */
+        void evict(BeladyEvictionEntry* node);
+
+    public:
+        ~OfflineEviction();
+
+        void set_next_access(unsigned long long request, unsigned long long next_access);
+
+        void hourly_purging(unsigned long timestamp);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+class BeladyEviction : public OfflineEviction {
+    private:
+        IndexedHeap<BeladyEvictionEntry, BeladyLess> heap;
+
+    public:
+        BeladyEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+
+        /*
+         * evicts the entry requested again furthest in the future
+         */
+        bool purge_regular();
+};
+
+class BeladySizeEviction : public OfflineEviction {
+    private:
+        std::vector<BeladyEvictionEntry*> entries; // coming back, sampled
+        std::vector<BeladyEvictionEntry*> never_again;
+
+        void place(BeladyEvictionEntry* node);
+        void unplace(BeladyEvictionEntry* node);
+
+    public:
+        BeladySizeEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+
+        /*
+         * evicts an entry never requested again, else the largest size times
+         * distance of BELADY_SIZE_SAMPLES random entries
+         */
+        bool purge_regular();
+};
+
+#endif /* BELADY_EVICTION_H_ */
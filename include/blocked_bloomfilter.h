@@ -0,0 +1,271 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+/*
+ * Blocked (cache line) bloom filter
+ *
+ * One murmur3_128 pass per key: the first 64 bits pick a 64 byte block, the
+ * second 64 bits give the nfuncs probe positions inside that block by double
+ * hashing. A lookup touches one cache line instead of nfuncs random ones.
+ * Same interface as BloomFilter, selected with -D BLOCKED_BF; with CBF the
+ * block holds 128 packed 4 bit counters instead of 512 bits.
+ *
+ * A key's probes are first turned into a mask over the block's eight 64 bit
+ * words, then every word is tested or updated at once (SWAR). Counters are
+ * split into even and odd nibbles so each sits in its own byte lane and the
+ * compare against n can't borrow into its neighbour.
+ *
+ * Set bits (full counters with CBF) are counted as they change, so stats
+ * don't scan the filter. With -D BF_HUGEPAGES the filter is 2MB aligned and
+ * advised to the kernel for transparent huge pages.
+ */
+
+#ifndef BLOCKED_BLOOMFILTER_H__
+#define BLOCKED_BLOOMFILTER_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <sys/mman.h>
+#include "hashfunc.h"
+#include "bloomfilter.h"
+
+#define BBF_BLOCK_BYTES 64
+#define BBF_WORDS (BBF_BLOCK_BYTES / 8)
+#define BBF_LANE_ONES 0x0101010101010101ULL
+#define BBF_LANE_HIGH 0x8080808080808080ULL
+#define BBF_NIBBLES 0x0F0F0F0F0F0F0F0FULL
+#define BBF_COUNTER_MAX 15
+#define BBF_HASH_SEED 0x9747b28c
+#ifdef BF_HUGEPAGES
+#define BBF_ALIGN (2 * 1024 * 1024)
+#else
+#define BBF_ALIGN BBF_BLOCK_BYTES
+#endif
+
+/* A key hashed once, reusable across filters of any size */
+struct BloomKey
+{
+    uint64_t block_hash;
+    uint32_t probe;
+    uint32_t step;
+};
+
+class BlockedBloomFilter {
+
+    private:
+        uint8_t * blocks;
+        unsigned long nblocks;
+        unsigned long bfsize; // bits, or counters with CBF
+        size_t nfuncs;
+        static const size_t max_hash = 10;
+        int NVAL;	// overall n value for n-hit caching (when =1, then works as 2nd hit caching)
+        int CUS_NVAL; // n value for individual customers
+
+#ifndef CBF
+        static const unsigned int slots_per_block = BBF_BLOCK_BYTES * 8;
+        unsigned long set_bits;
+#else
+        static const unsigned int slots_per_block = BBF_BLOCK_BYTES * 2;
+        unsigned long int cbf_full_bucket_count;
+
+        /* 0x01 in every byte lane holding a counter >= n (counters <= 15) */
+        static inline uint64_t lanes_at_least(uint64_t lanes, int n) {
+            return (((lanes | BBF_LANE_HIGH) - n * BBF_LANE_ONES) & BBF_LANE_HIGH) >> 7;
+        }
+#endif
+
+        inline uint64_t * block_of(const BloomKey & k) {
+            return (uint64_t *) (blocks + (k.block_hash % nblocks) * BBF_BLOCK_BYTES);
+        }
+
+        /* probe i of the key, inside its block */
+        inline unsigned int slot(const BloomKey & k, unsigned int i) {
+            return (k.probe + i * k.step) & (slots_per_block - 1);
+        }
+
+        /* one bit per probe, or with CBF the low bit of each probed counter */
+        inline void probe_mask(const BloomKey & k, uint64_t mask[BBF_WORDS]) {
+            for (unsigned int w = 0; w < BBF_WORDS; w++)
+                mask[w] = 0;
+            for (unsigned int i = 0; i < nfuncs; i++) {
+                unsigned int s = slot(k, i);
+#ifndef CBF
+                mask[s >> 6] |= 1ULL << (s & 63);
+#else
+                mask[s >> 4] |= 1ULL << ((s & 15) << 2);
+#endif
+            }
+        }
+
+    public:
+        typedef BloomKey key_type;
+
+        static inline BloomKey make_key(const char * url) {
+            uint64_t h[2];
+            murmur3_128(url, strlen(url), BBF_HASH_SEED, h);
+            BloomKey k;
+            k.block_hash = h[0];
+            k.probe = (uint32_t) h[1];
+            k.step = (uint32_t) (h[1] >> 32) | 1; // odd, so the probes don't repeat
+            return k;
+        }
+
+        BlockedBloomFilter(const char * BFfilename, size_t _nfuncs, unsigned long _size, int _NVAL){
+
+            FILE *bfFile;
+            nfuncs = _nfuncs;
+
+#ifdef CNVAL
+            CUS_NVAL = _NVAL;
+            NVAL = 1;	// (when =1, then works as 2nd hit caching)
+#else
+            CUS_NVAL = _NVAL;
+            NVAL = _NVAL;
+#endif
+
+            if (_nfuncs>max_hash){
+                printf("Number of hash functions (%d) is more than the Max hash functions (%d)! \n", (int)nfuncs , (int)max_hash);
+                exit(1);
+            }
+
+#ifdef CBF
+            if (_NVAL > BBF_COUNTER_MAX){
+                printf("N value (%d) does not fit in a 4 bit counter (max %d)! \n", _NVAL, BBF_COUNTER_MAX);
+                exit(1);
+            }
+#endif
+
+            nblocks = (_size + slots_per_block - 1) / slots_per_block;
+            if (nblocks == 0) {
+                nblocks = 1;
+            }
+            bfsize = nblocks * slots_per_block;
+
+            size_t bytes = nblocks * BBF_BLOCK_BYTES;
+            bytes = (bytes + BBF_ALIGN - 1) / BBF_ALIGN * BBF_ALIGN;
+            if (posix_memalign((void **) &blocks, BBF_ALIGN, bytes) != 0) {
+                fprintf(stderr, "Unable to create the blocked bloom filter (posix_memalign error)! \n");
+                exit(1);
+            }
+#ifdef BF_HUGEPAGES
+            madvise(blocks, bytes, MADV_HUGEPAGE);
+#endif
+            memset(blocks, 0, bytes);
+
+#ifndef CBF
+            set_bits = 0;
+
+            //open file
+            if((bfFile = fopen(BFfilename, "rb"))!=NULL){
+
+                // Loading the bloom filter from the file
+                if(fread(blocks, nblocks * BBF_BLOCK_BYTES, 1, bfFile) != 1){
+                    printf( "File %s:  read error!\n", BFfilename );
+                }
+                fclose(bfFile);
+                set_bits = count_ones();
+            }
+#else
+            cbf_full_bucket_count = 0;
+            (void) bfFile;
+#endif
+        }
+
+        ~BlockedBloomFilter(){
+            free(blocks);
+        }
+
+        unsigned long int count_ones(){
+            unsigned long int _count=0;
+            for (uint8_t * p = blocks; p != blocks + nblocks * BBF_BLOCK_BYTES; p++)
+                _count += bit_set_table_256[*p];
+            return _count;
+        }
+
+        inline void add(const BloomKey & k, int n){
+            uint64_t * b = block_of(k);
+            uint64_t mask[BBF_WORDS];
+            probe_mask(k, mask);
+            for (unsigned int w=0; w<BBF_WORDS; w++) {
+#ifndef CBF
+                (void) n;
+                set_bits += __builtin_popcountll(mask[w] & ~b[w]);
+                b[w] |= mask[w];
+#else
+                // saturate at n, count the counters that just reached it
+                uint64_t even = b[w] & BBF_NIBBLES;
+                uint64_t odd = (b[w] >> 4) & BBF_NIBBLES;
+                uint64_t inc_even = mask[w] & BBF_LANE_ONES & ~lanes_at_least(even, n);
+                uint64_t inc_odd = (mask[w] >> 4) & BBF_LANE_ONES & ~lanes_at_least(odd, n);
+                even += inc_even;
+                odd += inc_odd;
+                cbf_full_bucket_count += __builtin_popcountll(lanes_at_least(even, n) & inc_even)
+                    + __builtin_popcountll(lanes_at_least(odd, n) & inc_odd);
+                b[w] = even | (odd << 4);
+#endif
+            }
+        }
+
+        inline bool check(const BloomKey & k, int n){
+            uint64_t * b = block_of(k);
+            uint64_t mask[BBF_WORDS];
+            probe_mask(k, mask);
+            uint64_t missing = 0;
+            for (unsigned int w=0; w<BBF_WORDS; w++) {
+#ifndef CBF
+                (void) n;
+                missing |= mask[w] & ~b[w];
+#else
+                uint64_t even = b[w] & BBF_NIBBLES;
+                uint64_t odd = (b[w] >> 4) & BBF_NIBBLES;
+                missing |= mask[w] & BBF_LANE_ONES & ~lanes_at_least(even, n);
+                missing |= (mask[w] >> 4) & BBF_LANE_ONES & ~lanes_at_least(odd, n);
+#endif
+            }
+            return missing == 0;
+        }
+
+        inline void add(const BloomKey & k)     { add(k, NVAL); }
+        inline bool check(const BloomKey & k)   { return check(k, NVAL); }
+        inline void add(char * url)             { add(make_key(url), NVAL); }
+        inline bool check(char * url)           { return check(make_key(url), NVAL); }
+
+#ifdef CNVAL
+        inline void c_add(char * url)           { add(make_key(url), CUS_NVAL); }	// add for a particular customer
+        inline bool c_check(char * url)         { return check(make_key(url), CUS_NVAL); }
+#endif
+
+        inline void flush(){
+            memset(blocks, 0, nblocks * BBF_BLOCK_BYTES);
+#ifndef CBF
+            set_bits = 0;
+#else
+            cbf_full_bucket_count = 0;
+#endif
+        }
+
+        inline unsigned int get_size_KB()               {return bfsize/1024/8;}
+
+        void get_live_stats(struct bloom_filter_stats & stat)
+        {
+            stat.nfuncs = nfuncs;
+            unsigned long int _count=0;
+#ifndef CBF
+            stat.size_MB = bfsize / 1024 / 1024 / 8;
+            _count = set_bits;
+#else
+            stat.size_MB = (4*bfsize) / 1024 / 1024 / 8;
+            _count = cbf_full_bucket_count;
+#endif
+
+            stat.num_of_set_bits = _count;
+            stat.fill_percentage = 100.00 * _count / bfsize;
+            stat.theoretical_FPR_percentage = 100 * pow (1.00 * _count / bfsize, nfuncs);
+        }
+};
+
+#endif
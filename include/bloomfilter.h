@@ -60,18 +60,57 @@ class BloomFilter {
         static const size_t max_hash = 10;
         int NVAL;	// overall n value for n-hit caching (when =1, then works as 2nd hit caching)
         int CUS_NVAL; // n value for individual customers
+        hash64_fn hash_fn; // NULL: a separate bkdr hash per function
+
+        /*
+         * With hash_fn a key is hashed once and its probes are h1 + i * h2
+         * (double hashing), otherwise probe i is bkdr with seed i
+         */
+        inline void hash_key(const char * url, uint64_t & h1, uint64_t & h2) {
+            h1 = h2 = 0;
+            if (hash_fn) {
+                h1 = hash_fn(url, strlen(url), 0);
+                h2 = fmix64(h1) | 1;
+            }
+        }
+
+        inline unsigned long probe(const char * url, unsigned int i, uint64_t h1, uint64_t h2) {
+            if (!hash_fn)
+                return bkdr_hash_64_2_ind(url,i)%bfsize;
+            return (h1 + i * h2)%bfsize;
+        }
 
 #ifdef CBF
+        // two 4 bit counters per byte, they saturate at the n value
         uint8_t * cbf;
         unsigned long int cbf_full_bucket_count;
+        static const int max_counter = 15;
+
+        inline int cbf_get(unsigned long i) {
+            return (cbf[i >> 1] >> ((i & 1) << 2)) & 0x0F;
+        }
+
+        /* +1 unless already at n, counts the counters reaching n */
+        inline void cbf_add(unsigned long i, int n) {
+            if (cbf_get(i) < n) {
+                cbf[i >> 1] += 1 << ((i & 1) << 2);
+                if (cbf_get(i) == n)
+                    cbf_full_bucket_count++;
+            }
+        }
 #endif
 
     public:
+        // Keys are hashed inside every call, see BlockedBloomFilter::make_key
+        typedef char * key_type;
+        static inline char * make_key(const char * url)  {return (char *) url;}
+
         BloomFilter(const char * BFfilename, size_t _nfuncs, unsigned long _size, int _NVAL){
 
             FILE *bfFile;
             nfuncs = _nfuncs;
             bfsize = _size;
+            hash_fn = NULL;
 
 #ifdef CNVAL
             CUS_NVAL = _NVAL;
@@ -93,7 +132,11 @@ class BloomFilter {
             }
 
 #ifdef CBF
-            cbf = new uint8_t[bfsize]();
+            if (_NVAL > max_counter){
+                printf("N value (%d) does not fit in a 4 bit counter (max %d)! \n", _NVAL, max_counter);
+                exit(1);
+            }
+            cbf = new uint8_t[(bfsize + 1) / 2]();
             cbf_full_bucket_count = 0;
 #endif
 
@@ -108,6 +151,9 @@ class BloomFilter {
             } // else	fprintf(stderr,"Unable to open the bloom-filter file %s or it does not exist! \n", BFfilename);
         }
 
+        /* One of hashfunc.h's hash_family, NULL for the per-function bkdr hashes */
+        inline void set_hash(hash64_fn fn)  {hash_fn = fn;}
+
         unsigned long int count_ones(){
             unsigned long int _count=0;
             for (unsigned char * p = bloomfilter; p != bloomfilter + bitmapsize(bfsize); p++)
@@ -115,54 +161,43 @@ class BloomFilter {
             return _count;
         }
 
-        inline void add(char * url){
-            for (unsigned int i=0; i<nfuncs; i++)
+        /* n-hit with a runtime n (per customer), plain bits ignore it */
+        inline void add(char * url, int n){
+            uint64_t h1, h2;
+            hash_key(url, h1, h2);
 #ifndef CBF
-                setbit(bkdr_hash_64_2_ind(url,i)%bfsize, bloomfilter);
-#else
-            if(cbf[bkdr_hash_64_2_ind(url,i)%bfsize] < NVAL) {
-                cbf[bkdr_hash_64_2_ind(url,i)%bfsize]++;
-                if(cbf[bkdr_hash_64_2_ind(url,i)%bfsize] == NVAL)
-                    cbf_full_bucket_count++;
-            }
+            (void) n;
 #endif
-        }
-
-        inline bool check(char * url){
             for (unsigned int i=0; i<nfuncs; i++)
 #ifndef CBF
-                if (!(getbit(bkdr_hash_64_2_ind(url,i)%bfsize, bloomfilter)))
+                setbit(probe(url, i, h1, h2), bloomfilter);
 #else
-                    if(cbf[bkdr_hash_64_2_ind(url,i)%bfsize] < NVAL)
+                cbf_add(probe(url, i, h1, h2), n);	// full count is per n value
 #endif
-                        return false;
-            return true;
         }
 
-#ifdef CNVAL
-        inline void c_add(char * url){	// add for a particular customer
-            for (unsigned int i=0; i<nfuncs; i++)
+        inline bool check(char * url, int n){
+            uint64_t h1, h2;
+            hash_key(url, h1, h2);
 #ifndef CBF
-                setbit(bkdr_hash_64_2_ind(url,i)%bfsize, bloomfilter);
-#else
-            if(cbf[bkdr_hash_64_2_ind(url,i)%bfsize] < CUS_NVAL) {
-                cbf[bkdr_hash_64_2_ind(url,i)%bfsize]++;
-                if(cbf[bkdr_hash_64_2_ind(url,i)%bfsize] == CUS_NVAL)
-                    cbf_full_bucket_count++;	// this will be inconsistent now
-            }
+            (void) n;
 #endif
-        }
-
-        inline bool c_check(char * url){
             for (unsigned int i=0; i<nfuncs; i++)
 #ifndef CBF
-                if (!(getbit(bkdr_hash_64_2_ind(url,i)%bfsize, bloomfilter)))
+                if (!(getbit(probe(url, i, h1, h2), bloomfilter)))
 #else
-                    if(cbf[bkdr_hash_64_2_ind(url,i)%bfsize] < CUS_NVAL)
+                    if(cbf_get(probe(url, i, h1, h2)) < n)
 #endif
                         return false;
             return true;
         }
+
+        inline void add(char * url)             {add(url, NVAL);}
+        inline bool check(char * url)           {return check(url, NVAL);}
+
+#ifdef CNVAL
+        inline void c_add(char * url)           {add(url, CUS_NVAL);}	// add for a particular customer
+        inline bool c_check(char * url)         {return check(url, CUS_NVAL);}
 #endif
 
         void write_to_disk(std::string m_file_name)
@@ -253,6 +288,10 @@ class BloomFilter {
 
         inline void flush(){
             memset (bloomfilter, 0, bitmapsize(bfsize));
+#ifdef CBF
+            memset (cbf, 0, (bfsize + 1) / 2);
+            cbf_full_bucket_count = 0;
+#endif
         }
 
         inline unsigned int get_size_KB()               {return bfsize/1024/8;}
@@ -274,7 +313,7 @@ class BloomFilter {
             for (unsigned char * p = bloomfilter; p != bloomfilter + bitmapsize(bfsize); p++)
                 _count += bit_set_table_256[*(unsigned char*)p];
 #else
-            stat.size_MB = (8*bfsize) / 1024 / 1024 / 8;
+            stat.size_MB = (4*bfsize) / 1024 / 1024 / 8;
             _count = cbf_full_bucket_count;
 #endif
 
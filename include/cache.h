@@ -59,6 +59,8 @@ class Cache {
         // Setup Interfaces
         void set_admission(CacheAdmission* new_ad);
         void set_eviction(CacheEviction* new_ev);
+        // Seeds the admission and eviction random streams, after setting them
+        void set_seed(unsigned long long seed);
 
         // Main Cache interface 
         bool process(item_packet* ip_inst);
@@ -12,15 +12,26 @@
 #ifndef CACHE_POLICY_H_
 #define CACHE_POLICY_H_
 
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "prng.h"
+
 class CacheAdmission {
     protected:
         std::string name;
+        Prng rng; // seeded per cache layer, see Emulator::add_to_tail
 
     public:
         virtual ~CacheAdmission();
+        virtual void set_seed(uint64_t seed);
         // Is this key present?
         virtual bool check(std::string key, unsigned long data, unsigned long long size,
                            unsigned long ts, std::string customer_id_str)=0;
+        // The cache had it, for policies that count every request (no-op by default)
+        virtual void record_hit(const std::string& key, unsigned long long size,
+                                unsigned long ts, const std::string& customer_id_str);
         // Reporting
         virtual void periodic_output(unsigned long ts, std::ostringstream& outlogfile)=0;
 };
@@ -31,6 +42,7 @@ class CacheEviction {
         virtual ~CacheEviction();
 
         void set_total_capacity_by_value(unsigned long long size);
+        virtual void set_seed(uint64_t seed);
 
 
         // Put an object in the cache
@@ -42,6 +54,21 @@ class CacheEviction {
         // Check to see if an object is in the cache
         virtual int check(std::string key, unsigned long ts)=0;	// to check if present.
 
+        /*
+         * The (key, size) entries a put of `incoming` bytes would evict, in
+         * eviction order, at most max_victims of them. Empty if it fits.
+         * Returns false if the policy can't tell (the default).
+         */
+        virtual bool peek_victims(unsigned long long incoming, size_t max_victims,
+                                  std::vector<std::pair<std::string, unsigned long> >& victims);
+
+        /*
+         * Offline runs only, see NextAccessOracle: the request about to be
+         * checked is number `request` and its key comes back at request
+         * `next_access`, NEXT_ACCESS_NEVER if not. No-op by default.
+         */
+        virtual void set_next_access(unsigned long long request, unsigned long long next_access);
+
         // Reporting and debugging 
         virtual unsigned long long get_size()=0;
         virtual unsigned long long get_total_capacity()=0;
@@ -60,6 +87,7 @@ class CacheEviction {
 
     protected:
         std::string name;
+        Prng rng; // seeded per cache layer, see Emulator::add_to_tail
 
     private:
         unsigned long long total_capacity;
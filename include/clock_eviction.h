@@ -0,0 +1,126 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * CLOCK and SIEVE Cache Eviction Policies
+ *
+ * Entries sit in a slot array swept by a hand, each slot has a small counter
+ * in a packed array next to it. A hit only bumps the counter, there is no
+ * list to relink. The hand evicts the first entry whose counter is 0 and
+ * takes one off every non zero counter it passes.
+ *
+ * CLOCK puts a new entry in the slot last freed (just behind the hand) and
+ * its counter has clock_bits bits, 1 bit being second chance. SIEVE has 1
+ * bit and appends new entries at the end, so the slot order stays insertion
+ * order and the entries the hand passes keep their place instead of being
+ * moved to the newest end. Holes left by evictions are squeezed out once
+ * they are more than half the array.
+ */
+
+#ifndef CLOCK_EVICTION_H_
+#define CLOCK_EVICTION_H_
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define CLOCK_MAX_BITS 8
+#define CLOCK_MIN_COMPACT 1024 // slots, don't bother with smaller arrays
+
+/* n counters of 1 to 8 bits, as many per 64 bit word as fit */
+class PackedCounters {
+    private:
+        std::vector<uint64_t> words;
+        unsigned int bits;
+        unsigned int per_word;
+        uint64_t mask;
+
+    public:
+        PackedCounters(unsigned int bits = 1) {
+            this->bits = bits;
+            per_word = 64 / bits;
+            mask = (1ULL << bits) - 1;
+        }
+
+        inline unsigned int max_value() const { return mask; }
+
+        inline void resize(size_t n) {
+            words.resize((n + per_word - 1) / per_word, 0);
+        }
+
+        inline unsigned int get(size_t i) const {
+            return (words[i / per_word] >> ((i % per_word) * bits)) & mask;
+        }
+
+        inline void set(size_t i, unsigned int value) {
+            uint64_t& w = words[i / per_word];
+            unsigned int shift = (i % per_word) * bits;
+            w = (w & ~(mask << shift)) | ((uint64_t) value << shift);
+        }
+};
+
+struct ClockEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    unsigned long data;
+    unsigned long timestamp;
+    unsigned long count; // keep track of request count
+    size_t slot;
+};
+
+class ClockEviction : public CacheEviction {
+    protected:
+        const EmConfItems* sci;
+
+        std::unordered_map<std::string, ClockEvictionEntry*> _mapping;
+        std::vector<ClockEvictionEntry*> slots; // NULL for a hole
+        std::vector<size_t> free_slots; // reused by CLOCK only
+        PackedCounters counters; // one per slot
+        size_t hand;
+        size_t holes;
+        bool reuse_holes;
+
+        unsigned long long current_size;
+        unsigned long long total_capacity;
+        std::string cache_id; // k=kernel, h=hdd
+
+        // Reset every periodic_output
+        unsigned long evicted;
+        unsigned long long evicted_bytes;
+        unsigned long long hand_steps; // slots looked at by the hand
+        unsigned long compactions;
+
+        ClockEviction(unsigned long long size, std::string id, const EmConfItems * sci,
+                      unsigned int bits, bool reuse_holes);
+        void compact();
+
+    public:
+        ClockEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+        ~ClockEviction();
+
+        void hourly_purging(unsigned long timestamp);
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        /*
+         * moves the hand to the next entry with a 0 counter and evicts it
+         */
+        bool purge_regular();
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+class SieveEviction : public ClockEviction {
+    public:
+        SieveEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+};
+
+#endif /* CLOCK_EVICTION_H_ */
@@ -0,0 +1,117 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Admission combinators
+ *
+ * Build one CacheAdmission out of others: AND, OR, NOT, and gates that only
+ * send some requests (by size or by customer) to the inner policy. Branches
+ * are asked left to right and stop as soon as the answer is known, so put
+ * the cheap test first and e.g. a size gate saves the bloom filter probe.
+ *
+ * A combinator owns its branches and deletes them. Periodic output is the
+ * combinator's counters followed by each branch's own output, depth first:
+ * " : and admitted rejected <accepted rejected per branch> : <branch> ...".
+ */
+
+#ifndef COMBINED_ADMISSION_H_
+#define COMBINED_ADMISSION_H_
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include "cache_policy.h"
+
+class AdmissionCombinator : public CacheAdmission {
+    protected:
+        std::vector<CacheAdmission*> branches; // owned
+
+        // Reset every periodic_output
+        unsigned long admitted;
+        unsigned long rejected;
+        std::vector<unsigned long> branch_accepted;
+        std::vector<unsigned long> branch_rejected;
+
+        void add_branch(CacheAdmission* branch);
+        /* branch i's answer, counted */
+        bool ask(size_t i, const std::string& key, unsigned long data, unsigned long long size,
+                 unsigned long ts, const std::string& customer_id_str);
+        /* counts the combinator's own answer */
+        inline bool decide(bool admit) {
+            if (admit) {
+                admitted++;
+            } else {
+                rejected++;
+            }
+            return admit;
+        }
+
+    public:
+        AdmissionCombinator();
+        ~AdmissionCombinator();
+
+        /* Branches get their own streams derived from the seed */
+        void set_seed(uint64_t seed);
+        /* Every branch sees every hit */
+        void record_hit(const std::string& key, unsigned long long size,
+                        unsigned long ts, const std::string& customer_id_str);
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+/* Admit only if both admit, b is not asked when a rejects */
+class AndAdmission : public AdmissionCombinator {
+    public:
+        AndAdmission(CacheAdmission* a, CacheAdmission* b);
+        bool check(std::string key, unsigned long data, unsigned long long size,
+                   unsigned long ts, std::string customer_id_str);
+};
+
+/* Admit if either admits, b is not asked when a admits */
+class OrAdmission : public AdmissionCombinator {
+    public:
+        OrAdmission(CacheAdmission* a, CacheAdmission* b);
+        bool check(std::string key, unsigned long data, unsigned long long size,
+                   unsigned long ts, std::string customer_id_str);
+};
+
+class NotAdmission : public AdmissionCombinator {
+    public:
+        NotAdmission(CacheAdmission* a);
+        bool check(std::string key, unsigned long data, unsigned long long size,
+                   unsigned long ts, std::string customer_id_str);
+};
+
+/*
+ * Requests with min_size <= size < max_size (max_size 0: no upper bound) are
+ * decided by inner, the others get outside without asking it
+ */
+class SizeGatedAdmission : public AdmissionCombinator {
+    private:
+        unsigned long long min_size;
+        unsigned long long max_size;
+        bool outside;
+
+    public:
+        SizeGatedAdmission(unsigned long long min_size, unsigned long long max_size,
+                           CacheAdmission* inner, bool outside);
+        bool check(std::string key, unsigned long data, unsigned long long size,
+                   unsigned long ts, std::string customer_id_str);
+};
+
+/* Listed customers are decided by inner, the others get outside */
+class CustomerGatedAdmission : public AdmissionCombinator {
+    private:
+        std::unordered_set<std::string> customers;
+        bool outside;
+
+    public:
+        CustomerGatedAdmission(const std::vector<std::string>& customers,
+                               CacheAdmission* inner, bool outside);
+        bool check(std::string key, unsigned long data, unsigned long long size,
+                   unsigned long ts, std::string customer_id_str);
+};
+
+#endif /* COMBINED_ADMISSION_H_ */
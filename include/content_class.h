@@ -0,0 +1,21 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Content class of an object, from the extension of its url
+ *
+ * Cheap enough to be a feature of learned policies. Cache keys are the url
+ * without its query, so they work as well.
+ */
+
+#ifndef CONTENT_CLASS_H_
+#define CONTENT_CLASS_H_
+
+#include <string>
+
+enum ContentClass { CONTENT_OTHER, CONTENT_VIDEO, CONTENT_MANIFEST, CONTENT_IMAGE,
+                    CONTENT_WEB, CONTENT_DOWNLOAD, CONTENT_CLASSES };
+
+ContentClass content_class(const std::string& url);
+
+#endif /* CONTENT_CLASS_H_ */
@@ -9,6 +9,11 @@
 #ifndef SIZE_LRU_EVICTION_H_
 #define SIZE_LRU_EVICTION_H_
 
+#include <stdint.h>
+#include <map>
+
+#include "customer_recency.h"
+
 struct s_item_attr
 {
     s_item_attr()
@@ -28,8 +33,31 @@ struct CostLRUEvictionEntry
     unsigned long count; // keep track of request count
     CostLRUEvictionEntry* prev;
     CostLRUEvictionEntry* next;
+
+    // this customer's recency list (see customer_recency.h)
+    CustomerRecency<CostLRUEvictionEntry>* cust;
+    CostLRUEvictionEntry* cust_prev;
+    CostLRUEvictionEntry* cust_next;
+
+    // position in the size based purge window (see refill_size_window)
+    bool in_window;
+    std::multimap<unsigned long, CostLRUEvictionEntry*>::iterator window_it;
+
+    unsigned short score_class; // quantized size (and bypass) bucket
+    CostLRUEvictionEntry* class_prev;
+    CostLRUEvictionEntry* class_next;
 };
 
+/*
+ * Entries are bucketed by quantized log2(size) (and, for eviction_formula 2,
+ * by whether the customer bypasses the bloom filter). Every eviction formula
+ * is monotone in age for a fixed size, so the worst entry of a bucket is
+ * always the LRU tail of that bucket and only the bucket tails need scoring.
+ */
+#define COST_LRU_CLASSES_PER_OCTAVE 4
+#define COST_LRU_SIZE_CLASSES 256
+#define COST_LRU_SCORE_CLASSES (2 * COST_LRU_SIZE_CLASSES)
+
 
 
 class CostLRUEviction : public CacheEviction {
@@ -37,6 +65,7 @@ class CostLRUEviction : public CacheEviction {
         const EmConfItems* sci;
 
         std::unordered_map< std::string, CostLRUEvictionEntry*>	_mapping;
+        CustomerRecencyIndex<CostLRUEvictionEntry>	customer_recency;
         std::vector<unsigned int>			avg_oldest_requested_file_vector;
         unsigned long long				current_size;
         unsigned long long				total_capacity;
@@ -70,6 +99,13 @@ class CostLRUEviction : public CacheEviction {
         double 							m_w_origin_cost, w_size, w_age, w_item_attr_val;
         std::unordered_map<std::string, s_item_attr> m_item_unordered_map;
 
+        // The purge_size_based_limit least recently used entries, ordered by
+        // size. Everything from window_front back to the tail is covered
+        // (window_front == tail when nothing is).
+        std::multimap<unsigned long, CostLRUEvictionEntry*> size_window;
+        CostLRUEvictionEntry*			window_front;
+        unsigned int					window_span;
+
         double							running_size_mu, running_size_var;
         double							alpha_running_size_mu, alpha_running_size_var;
         long							hour_count;
@@ -79,11 +115,11 @@ class CostLRUEviction : public CacheEviction {
         int                             ef4_y;
         float                           ef4_e;
 
-        // Customer hit stats brought in here from emstructs and the old
-        // reporting variables objects
-	    std::unordered_map<std::string,
-		std::unordered_map<std::string, unsigned long> > customer_hit_stats;
-	    void compute_periodic_stats(bool floor_customer_loss);
+        // Per score class recency lists, plus a bitmap of the non-empty ones
+        CostLRUEvictionEntry**          class_head;
+        CostLRUEvictionEntry**          class_tail;
+        uint64_t                        class_bitmap[COST_LRU_SCORE_CLASSES / 64];
+
 
 
     public:
@@ -131,15 +167,13 @@ class CostLRUEviction : public CacheEviction {
         bool purge_regular();
         void weighted_purge();
         /*
-         * faster version (based on approximation)
-         * in progress
+         * customer_fair_eviction: evicts the oldest entry of the customer
+         * furthest over its byte budget (see customer_recency.h), plain LRU
+         * if every customer with cached entries is protected
          */
         void purge_customer_based_approx();
         /*
-         *
-         * this is the slow version. it is accurate.
-         * but very slow
-         * never ran this completely.
+         * purge_customer_based_approx() until we are back under capacity
          */
         void purge_customer_based();
         void dump_cache_contents(std::string filename);
@@ -159,21 +193,30 @@ class CostLRUEviction : public CacheEviction {
     private:
         void decide_items_based_on_score();
         void update_size_running_mean(CostLRUEvictionEntry* node);
-        void compute_scores();
+        double compute_score(CostLRUEvictionEntry* node);
+        unsigned short get_score_class(CostLRUEvictionEntry* node);
+        CostLRUEvictionEntry* pick_score_victim();
         void update_cost_based_score(CostLRUEvictionEntry* node);
 
         void detach(CostLRUEvictionEntry* node);
         void attach(CostLRUEvictionEntry* node);
 
+        /*
+         * evicts with purge_size_based() until we are back under capacity
+         */
         void purge_size_based_multimap();
 
         /*
          * FOR LRU ONLY
          * Here we purge based on size.
          * we look at the least recently requested "purge_size_based_limit" files
-         * and pick the one with the largest size
+         * and pick the one with the largest size. Evicts a single entry.
          */
         void purge_size_based();
+        void refill_size_window();
+        void reset_size_window();
+        bool skip_size_based_deletion(const std::string& customer_id);
+        void evict(CostLRUEvictionEntry* node);
 
         std::string return_customer_id(std::string url);
 };
@@ -0,0 +1,85 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * N-hit admission over a cuckoo filter
+ *
+ * Every tracked key is one 32 bit slot: a 16 bit fingerprint, a 4 bit hit
+ * counter and the 12 bit epoch it was last seen in. Unlike the bloom filters
+ * a key can be removed (on admit) and ages out on its own once it has not
+ * been seen for max_age seconds, instead of the whole filter being reset.
+ */
+
+#ifndef CUCKOO_ADMISSION_H_
+#define CUCKOO_ADMISSION_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "cache_policy.h"
+
+#define CUCKOO_SLOTS_PER_BUCKET 4
+#define CUCKOO_MAX_KICKS 500
+#define CUCKOO_EPOCHS_PER_AGE 16 // epoch length is max_age / this
+#define CUCKOO_EPOCH_MASK 0xFFF
+#define CUCKOO_COUNTER_MAX 15
+
+class CuckooAdmission : public CacheAdmission {
+    private:
+        std::vector<uint32_t> slots; // CUCKOO_SLOTS_PER_BUCKET per bucket
+        unsigned long bucket_mask; // bucket count is a power of 2
+
+        int NVAL; // admit once a key was seen NVAL times before
+        bool delete_on_admit;
+        std::vector<std::string> no_bf_cust;
+
+        unsigned long epoch_len; // seconds
+        unsigned long first_ts;
+        uint32_t current_epoch;
+        unsigned long sweep_bucket; // expiry sweep position
+
+        unsigned long occupied;
+
+        // Reset every periodic_output
+        unsigned long admitted;
+        unsigned long rejected;
+        unsigned long expired;
+        unsigned long dropped; // pushed out by a failed insert
+
+        static inline uint32_t fingerprint(uint32_t slot)   { return slot >> 16; }
+        static inline uint32_t counter(uint32_t slot)       { return (slot >> 12) & 0xF; }
+        static inline uint32_t epoch(uint32_t slot)         { return slot & CUCKOO_EPOCH_MASK; }
+        static inline uint32_t make_slot(uint32_t fp, uint32_t count, uint32_t ep) {
+            return (fp << 16) | (count << 12) | (ep & CUCKOO_EPOCH_MASK);
+        }
+
+        inline unsigned long alt_bucket(unsigned long bucket, uint32_t fp) {
+            // the partner bucket is recoverable from either side
+            return (bucket ^ (fp * 0x5bd1e995)) & bucket_mask;
+        }
+        inline bool is_expired(uint32_t slot) {
+            return ((current_epoch - epoch(slot)) & CUCKOO_EPOCH_MASK) >= CUCKOO_EPOCHS_PER_AGE;
+        }
+
+        uint32_t* find(unsigned long b1, unsigned long b2, uint32_t fp);
+        bool insert(unsigned long b1, unsigned long b2, uint32_t slot);
+        void sweep_one_bucket();
+
+    public:
+        CuckooAdmission(unsigned long capacity, int _NVAL, std::vector<std::string> no_bf_cust,
+                        unsigned long max_age, bool delete_on_admit);
+        ~CuckooAdmission();
+
+        bool check(std::string key, unsigned long data, unsigned long long size,
+                   unsigned long ts, std::string customer_id_str);
+        bool check_customer_in_list(std::string custid) const;
+
+        float get_fill_percentage();
+        /* Expected false positive rate (percent) at the current load */
+        float get_fpr_percentage();
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+#endif /* CUCKOO_ADMISSION_H_ */
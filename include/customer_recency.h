@@ -0,0 +1,264 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Per customer recency lists
+ *
+ * Every cached entry is also linked into a list of its customer's entries,
+ * kept in the same order as the policy's own list (attach at the new end,
+ * detach from anywhere). The oldest entry, bytes and object count of any
+ * customer are then O(1) instead of a walk over the whole cache.
+ *
+ * Entry needs customer_id, data, timestamp and the cust_prev/cust_next/cust
+ * fields.
+ *
+ * The same records carry the per customer state for customer-fair eviction:
+ * every CUSTOMER_BUDGET_INTERVAL seconds each customer gets a byte budget,
+ * its share of recently requested bytes weighted towards the cache wide byte
+ * hit ratio, and customers are ranked by how far over budget they are. The
+ * victim is the oldest entry of the top ranked one, O(log customers).
+ */
+
+#ifndef CUSTOMER_RECENCY_H_
+#define CUSTOMER_RECENCY_H_
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ostream>
+#include <unordered_map>
+
+#define CUSTOMER_BUDGET_INTERVAL 3600
+#define CUSTOMER_WEIGHT_MIN 0.25
+#define CUSTOMER_WEIGHT_MAX 4.0
+
+template <class Entry>
+struct CustomerRecency
+{
+    CustomerRecency()
+        : newest(NULL), oldest(NULL), bytes(0), count(0),
+          budget(0), demand(0), weight(1),
+          interval_bytes_requested(0), interval_bytes_hit(0),
+          byte_hit_ratio(0), protect(false)
+    {}
+    Entry* newest;
+    Entry* oldest;
+    unsigned long long bytes;
+    unsigned long count;
+
+    // customer-fair eviction
+    unsigned long long budget; // bytes this customer may hold
+    double demand; // smoothed bytes requested per budget interval
+    double weight; // > 1 when the customer hits less than the cache does
+    unsigned long long interval_bytes_requested;
+    unsigned long long interval_bytes_hit;
+    unsigned long byte_hit_ratio; // percent, last interval
+    bool protect; // floor_customer_loss: never pick as a victim
+};
+
+template <class Entry>
+class CustomerRecencyIndex {
+    private:
+        typedef std::pair<long long, CustomerRecency<Entry>*> rank_key;
+
+        // Records are never erased, entries keep pointers to them
+        std::unordered_map<std::string, CustomerRecency<Entry> > customers;
+
+        // Customers with something cached, by bytes over budget
+        std::set<rank_key> by_overage;
+        bool fair;
+        unsigned long next_budget_update;
+
+        static rank_key key(CustomerRecency<Entry>* c) {
+            return rank_key((long long) c->bytes - (long long) c->budget, c);
+        }
+        void unrank(CustomerRecency<Entry>* c) {
+            if (fair && c->count > 0 && !c->protect) {
+                by_overage.erase(key(c));
+            }
+        }
+        void rank(CustomerRecency<Entry>* c) {
+            if (fair && c->count > 0 && !c->protect) {
+                by_overage.insert(key(c));
+            }
+        }
+
+    public:
+        CustomerRecencyIndex()
+            : fair(false), next_budget_update(0)
+        {}
+
+        /* Keep the over budget ranking up to date from now on */
+        void enable_fairness() {
+            fair = true;
+            by_overage.clear();
+            for (typename std::unordered_map<std::string, CustomerRecency<Entry> >::iterator
+                 it = customers.begin(); it != customers.end(); ++it) {
+                rank(&it->second);
+            }
+        }
+
+        /* node becomes the newest entry of its customer */
+        void attach(Entry* node) {
+            CustomerRecency<Entry>* c = &customers[node->customer_id];
+            unrank(c);
+            node->cust = c;
+            node->cust_prev = NULL;
+            node->cust_next = c->newest;
+            if (c->newest) {
+                c->newest->cust_prev = node;
+            }
+            else {
+                c->oldest = node;
+            }
+            c->newest = node;
+            c->bytes += node->data;
+            c->count++;
+            rank(c);
+        }
+
+        void detach(Entry* node) {
+            CustomerRecency<Entry>* c = node->cust;
+            unrank(c);
+            if (node->cust_prev) {
+                node->cust_prev->cust_next = node->cust_next;
+            }
+            else {
+                c->newest = node->cust_next;
+            }
+            if (node->cust_next) {
+                node->cust_next->cust_prev = node->cust_prev;
+            }
+            else {
+                c->oldest = node->cust_prev;
+            }
+            c->bytes -= node->data;
+            c->count--;
+            rank(c);
+        }
+
+        /* A request for one of node's customer's objects, node is cached */
+        void record_request(Entry* node, unsigned long bytes, bool hit) {
+            node->cust->interval_bytes_requested += bytes;
+            if (hit) {
+                node->cust->interval_bytes_hit += bytes;
+            }
+        }
+
+        /*
+         * Oldest entry of the customer furthest over budget, NULL if every
+         * customer with cached entries is protected
+         */
+        Entry* fair_victim() {
+            if (by_overage.empty()) {
+                return NULL;
+            }
+            return by_overage.rbegin()->second->oldest;
+        }
+
+        bool is_protected(const std::string& customer_id) const {
+            const CustomerRecency<Entry>* c = find(customer_id);
+            return c != NULL && c->protect;
+        }
+
+        /*
+         * Recompute budgets once every CUSTOMER_BUDGET_INTERVAL of trace time.
+         * floor_customer_loss protects a customer whose byte hit ratio fell by
+         * 2 points or more since the last interval, until it recovers.
+         * True if that changed whether any customer is protected.
+         */
+        bool update_budgets(unsigned long ts, unsigned long long capacity,
+                            bool floor_customer_loss) {
+            if (ts < next_budget_update) {
+                return false;
+            }
+            next_budget_update = ts + CUSTOMER_BUDGET_INTERVAL;
+
+            typedef typename std::unordered_map<std::string, CustomerRecency<Entry> >::iterator iter;
+            unsigned long long total_requested = 0, total_hit = 0;
+            for (iter it = customers.begin(); it != customers.end(); ++it) {
+                total_requested += it->second.interval_bytes_requested;
+                total_hit += it->second.interval_bytes_hit;
+            }
+            double cache_hit_ratio = total_requested ? (double) total_hit / total_requested : 0;
+
+            bool protection_changed = false;
+            double total_weighted_demand = 0;
+            for (iter it = customers.begin(); it != customers.end(); ++it) {
+                CustomerRecency<Entry>* c = &it->second;
+                c->demand = 0.5 * c->demand + 0.5 * c->interval_bytes_requested;
+
+                if (c->interval_bytes_requested > 0) {
+                    double hit_ratio = (double) c->interval_bytes_hit / c->interval_bytes_requested;
+                    c->weight *= 1 + (cache_hit_ratio - hit_ratio);
+                    if (c->weight < CUSTOMER_WEIGHT_MIN) c->weight = CUSTOMER_WEIGHT_MIN;
+                    if (c->weight > CUSTOMER_WEIGHT_MAX) c->weight = CUSTOMER_WEIGHT_MAX;
+
+                    unsigned long percent = 100 * hit_ratio;
+                    if (floor_customer_loss) {
+                        int diff = (int) percent - (int) c->byte_hit_ratio;
+                        bool was_protected = c->protect;
+                        if (diff <= -2) {
+                            c->protect = true;
+                        }
+                        else if (diff >= 1) {
+                            c->protect = false;
+                        }
+                        protection_changed |= (c->protect != was_protected);
+                    }
+                    c->byte_hit_ratio = percent;
+                }
+                c->interval_bytes_requested = 0;
+                c->interval_bytes_hit = 0;
+
+                total_weighted_demand += c->demand * c->weight;
+            }
+
+            by_overage.clear();
+            for (iter it = customers.begin(); it != customers.end(); ++it) {
+                CustomerRecency<Entry>* c = &it->second;
+                c->budget = total_weighted_demand > 0 ?
+                    capacity * (c->demand * c->weight / total_weighted_demand) : 0;
+                rank(c);
+            }
+            return protection_changed;
+        }
+
+        /* NULL if the customer never had anything cached */
+        const CustomerRecency<Entry>* find(const std::string& customer_id) const {
+            typename std::unordered_map<std::string, CustomerRecency<Entry> >::const_iterator
+                it = customers.find(customer_id);
+            if (it == customers.end()) {
+                return NULL;
+            }
+            return &it->second;
+        }
+
+        /* Age in days of the customer's oldest entry, 0 if nothing cached */
+        float oldest_age_days(const std::string& customer_id, unsigned long ts) const {
+            const CustomerRecency<Entry>* c = find(customer_id);
+            if (c == NULL || c->oldest == NULL) {
+                return 0;
+            }
+            return (float) (ts - c->oldest->timestamp)/60/60/24;
+        }
+
+        /*
+         * For periodic_output: the number of customers, then oldest age
+         * (days), bytes and objects for each of them
+         */
+        void periodic_output(const std::vector<std::string>& customer_ids, unsigned long ts,
+                             std::ostream& output) const {
+            output << customer_ids.size() << " ";
+            for (std::vector<std::string>::const_iterator i = customer_ids.begin(); i != customer_ids.end(); ++i) {
+                const CustomerRecency<Entry>* c = find(*i);
+                output << *i << " "
+                    << oldest_age_days(*i, ts) << " "
+                    << (c ? c->bytes : 0) << " "
+                    << (c ? c->count : 0) << " ";
+            }
+        }
+};
+
+#endif /* CUSTOMER_RECENCY_H_ */
@@ -0,0 +1,84 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Per customer admission thresholds
+ *
+ * Maps a customer id to its own N for N-hit admission and, optionally, a
+ * size from which its objects are never admitted. N = 0 lets the customer
+ * bypass the filter like no_bf_cust.
+ *
+ * Customer ids taken from the URL are 4 hex digits, so they are used
+ * directly as an index into a 65536 entry array (a dense id). Other ids fall
+ * back to a hash map. Given as "id:n[:max_size],..." (customer_nval / -U).
+ */
+
+#ifndef CUSTOMER_THRESHOLDS_H_
+#define CUSTOMER_THRESHOLDS_H_
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <unordered_map>
+
+#define CUSTOMER_DENSE_ID_DIGITS 4
+#define CUSTOMER_DENSE_IDS (1 << (4 * CUSTOMER_DENSE_ID_DIGITS))
+#define CUSTOMER_MAX_NVAL 15 // 4 bit counting bloom filter counters
+
+struct CustomerThreshold
+{
+    CustomerThreshold() : nval(-1), max_size(0) {}
+    int nval; // -1: not set, use the policy's N
+    unsigned long long max_size; // 0: no size limit
+};
+
+class CustomerThresholds {
+    private:
+        std::vector<CustomerThreshold> by_dense_id; // allocated on first use
+        std::unordered_map<std::string, CustomerThreshold> by_name;
+        std::vector<std::string> customers; // as given, for print()
+
+    public:
+        /* 0 .. CUSTOMER_DENSE_IDS - 1, or -1 if the id is not 4 hex digits */
+        static inline int dense_id(const std::string& customer_id) {
+            size_t len = customer_id.size();
+            if (len != CUSTOMER_DENSE_ID_DIGITS) {
+                return -1;
+            }
+            int id = 0;
+            for (size_t i = 0; i < len; i++) {
+                char c = customer_id[i];
+                int digit;
+                if (c >= '0' && c <= '9') digit = c - '0';
+                else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+                else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+                else return -1;
+                id = (id << 4) | digit;
+            }
+            return id;
+        }
+
+        void set(const std::string& customer_id, int nval, unsigned long long max_size);
+        /* Adds "id:n[:max_size],..." entries, false on a malformed one */
+        bool parse(const std::string& spec);
+
+        bool empty() const { return by_dense_id.empty() && by_name.empty(); }
+
+        /* NULL if the customer has no entry */
+        inline const CustomerThreshold* find(const std::string& customer_id) const {
+            int id = dense_id(customer_id);
+            if (id >= 0) {
+                if (by_dense_id.empty() || by_dense_id[id].nval < 0) {
+                    return NULL;
+                }
+                return &by_dense_id[id];
+            }
+            std::unordered_map<std::string, CustomerThreshold>::const_iterator it =
+                by_name.find(customer_id);
+            return it == by_name.end() ? NULL : &it->second;
+        }
+
+        void print(std::ostream& out) const;
+};
+
+#endif /* CUSTOMER_THRESHOLDS_H_ */
@@ -21,6 +21,7 @@
 #include <vector>
 #include <unordered_map>
 #include "status.h"
+#include "customer_thresholds.h"
 
 class ReportingVariables{
     public:
@@ -56,6 +57,15 @@ class EmConfItems {
 	    unsigned long long hd_gig;
 
         unsigned long bf_reset_int;
+        unsigned int bf_generations; // filters in the rotating admission ring
+        std::string bf_hash; // admission bloom filter hash, see find_hash()
+        CustomerThresholds customer_nval; // per customer N (and max size) for N-hit admission
+        unsigned long long seed; // policy random streams, defaults to the start time
+        unsigned long tinylfu_width; // TinyLFU sketch counters per row (~ objects tracked)
+        unsigned long cuckoo_slots; // keys tracked by cuckoo admission
+        bool cuckoo_delete_on_admit;
+        double learned_admission_threshold; // admit if the predicted chance of coming back is this or more
+        unsigned long learned_admission_window; // requests the learned admission waits for labels, 0 to follow the cache
 
 	    std::string periodic_reporting_logs_path;
 	    std::string periodic_reporting_err_logs_path;
@@ -85,6 +95,7 @@ class EmConfItems {
 	    unsigned int LRU_list_size;
 	    int regular_purge_interval; // do a regular purge every X hours
 	    bool floor_customer_loss; // for adaptive size based LRU
+	    bool customer_fair_eviction; // size/cost LRU: evict from the most over budget customer
 
 	    // cost-based-lru
 	    double w_size;
@@ -102,6 +113,14 @@ class EmConfItems {
 
         // Evistion Policy
         int hoc_ttl;
+        std::vector<double> s4lru_segment_shares; // capacity share per segment
+        unsigned int eviction_samples; // K for sampled eviction
+        std::string sample_scorer; // formula, age, frequency or size_age
+        unsigned int clock_bits; // CLOCK counter bits, 1 is second chance
+        std::string gdsf_cost; // 1, size or origin
+        std::unordered_map<std::string, double> origin_cost; // per byte origin cost by customer, 1 if not listed
+        double lirs_hir_share; // bytes for LIRS resident HIR objects
+        unsigned long lrb_window; // requests the learned eviction remembers and labels over
 
 	    bool check_customer_in_list(std::string custid, std::vector<std::string> m_list) const;
 	    void print_em_conf_items();
@@ -14,6 +14,7 @@
 class Cache;
 class ReportingVariables;
 class EmConfItems;
+class NextAccessOracle;
 
 /* Various log parse and mod utils */
 
@@ -71,13 +72,20 @@ class Emulator{
         // The first layer of caching
         Cache* head;
         Cache* tail;
+        // Each layer added gets the next seed from this splitmix64 stream
+        uint64_t seed_state;
 
         // Emulator Context
         time_t start_time;
 
         // Functions to Drive the Emulation
+        int parse_access_log_line(std::string log_line, item_packet& ip_inst);
         int process_access_log_line(std::string log_line);
         void populate_access_log_cache();
+        void populate_access_log_cache(std::istream& in);
+
+        // For offline policies, set before populating
+        void set_next_access_oracle(NextAccessOracle* new_oracle);
 
         std::ostream &output;
 
@@ -86,6 +94,8 @@ class Emulator{
         void emulator_periodic_reporting(item_packet* ip_inst);
         void execute_periodic_functions(item_packet* ip_inst);
 
+        NextAccessOracle* oracle; // NULL unless offline
+
         /* Are we using partial object caching */
         bool partial_object_caching;
         bool front_end_mode;
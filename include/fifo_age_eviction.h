@@ -11,12 +11,14 @@
 
 
 #include "fifo_eviction.h"
+#include "timer_wheel.h"
 
 class FIFOAgeEviction : public CacheEviction {
     private:
         const EmConfItems* sci;
 
         std::unordered_map< std::string, FIFOEvictionEntry*>	_mapping;
+        CustomerRecencyIndex<FIFOEvictionEntry>	customer_recency;
         std::vector<unsigned int>			avg_oldest_requested_file_vector;
         unsigned long long				current_size;
         unsigned long long				total_capacity;
@@ -52,6 +54,17 @@ class FIFOAgeEviction : public CacheEviction {
 
         unsigned long                   ttl; // Time until objects in cache expire
 
+        // Objects expire off this wheel as the trace clock moves, instead of
+        // sitting in the cache until they are requested again
+        TimerWheel                      ttl_wheel;
+        std::vector<FIFOEvictionEntry*> due_timers;
+
+        // Reset every periodic_output
+        unsigned long                   expired_count;
+        unsigned long long              expired_bytes;
+        unsigned long                   evicted_count;
+        unsigned long long              evicted_bytes;
+
     public:
         FIFOAgeEviction(unsigned long long size, std::string id, unsigned long ttl, const EmConfItems * sci);
         ~FIFOAgeEviction();
@@ -110,6 +123,10 @@ class FIFOAgeEviction : public CacheEviction {
     private:
         void detach(FIFOEvictionEntry* node);
         void attach(FIFOEvictionEntry* node);
+
+        /* Drops everything whose TTL ran out by ts */
+        void expire_due(unsigned long ts);
+        void expire(FIFOEvictionEntry* node);
 };
 
 #endif /* FIFO_EVICTION_H_ */
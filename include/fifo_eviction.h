@@ -9,8 +9,13 @@
 #ifndef FIFO_EVICTION_H_
 #define FIFO_EVICTION_H_
 
+#include "customer_recency.h"
+
 struct FIFOEvictionEntry
 {
+    FIFOEvictionEntry()
+        : timer_next(NULL), timer_pprev(NULL)
+    {}
     std::string key; // hash key
     std::string customer_id;
     std::string orig_url; // original URL
@@ -20,6 +25,17 @@ struct FIFOEvictionEntry
     unsigned long count; // keep track of request count
     FIFOEvictionEntry* prev;
     FIFOEvictionEntry* next;
+
+    // this customer's recency list (see customer_recency.h)
+    CustomerRecency<FIFOEvictionEntry>* cust;
+    FIFOEvictionEntry* cust_prev;
+    FIFOEvictionEntry* cust_next;
+
+    // TTL timer, see timer_wheel.h (timer_pprev is NULL when not scheduled)
+    unsigned long expires;
+    unsigned short timer_slot;
+    FIFOEvictionEntry* timer_next;
+    FIFOEvictionEntry** timer_pprev;
 };
 
 
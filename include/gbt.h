@@ -0,0 +1,66 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Small gradient boosted regression trees
+ *
+ * Squared error boosting of depth limited trees, enough for the learned
+ * eviction and with no dependency. Training bins every feature at up to
+ * GBT_BINS quantiles of its values, so finding a node's split is one
+ * histogram pass over its rows per feature. Prediction walks each tree, the
+ * nodes of all trees in one array.
+ */
+
+#ifndef GBT_H_
+#define GBT_H_
+
+#include <stddef.h>
+#include <vector>
+
+#define GBT_BINS 64
+
+struct GBTParams
+{
+    unsigned int trees;
+    unsigned int depth;
+    unsigned int min_leaf; // rows
+    float learning_rate;
+};
+
+struct GBTNode
+{
+    int feature; // -1 for a leaf
+    float threshold; // x[feature] <= threshold goes left
+    float value; // leaves, already scaled by the learning rate
+    unsigned int left; // node indexes
+    unsigned int right;
+};
+
+class GBTModel {
+    private:
+        std::vector<GBTNode> nodes;
+        std::vector<unsigned int> roots;
+        float base; // mean label
+
+        unsigned int grow(const std::vector<unsigned char>& bins, const std::vector<std::vector<float> >& edges,
+                          const std::vector<float>& residual, std::vector<unsigned int>& rows,
+                          size_t begin, size_t end, unsigned int depth, const GBTParams& params);
+
+    public:
+        GBTModel() : base(0) {}
+
+        inline bool empty() const               { return roots.empty(); }
+        inline size_t get_trees() const         { return roots.size(); }
+        inline size_t get_nodes() const         { return nodes.size(); }
+
+        /*
+         * Fits the model to n_rows rows of n_features in x, row major, and
+         * their labels y. Returns the root mean square training error.
+         */
+        double train(const std::vector<float>& x, const std::vector<float>& y,
+                     unsigned int n_features, const GBTParams& params);
+
+        float predict(const float* row) const;
+};
+
+#endif /* GBT_H_ */
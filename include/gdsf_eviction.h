@@ -0,0 +1,104 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * GreedyDual-Size-Frequency Cache Eviction Policy
+ *
+ * Every entry has priority clock + frequency * cost / size and the lowest
+ * one goes, setting clock to its priority so that entries which stop being
+ * requested age out. The entries are kept in an indexed 4-ary heap, a hit
+ * re-sorts its entry in O(log n). Ties go to the least recently used.
+ *
+ * gdsf_cost picks the cost of fetching an object: "1" (favors small objects,
+ * for hit ratio), "size" (frequency with aging, for byte hit ratio) or
+ * "origin" (size times the customer's origin_cost, 1 if not listed).
+ */
+
+#ifndef GDSF_EVICTION_H_
+#define GDSF_EVICTION_H_
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "indexed_heap.h"
+
+#define GDSF_MAX_PEEK_SCAN 64 // heap nodes looked at by peek_victims
+
+enum GDSFCost { GDSF_COST_ONE, GDSF_COST_SIZE, GDSF_COST_ORIGIN };
+
+struct GDSFEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    unsigned long data;
+    unsigned long timestamp;
+    unsigned long count; // keep track of request count
+    double cost;
+    double priority;
+    unsigned long long seq; // last touch, breaks ties
+    size_t heap_index;
+};
+
+struct GDSFLess {
+    inline bool operator()(const GDSFEvictionEntry* a, const GDSFEvictionEntry* b) const {
+        if (a->priority != b->priority) {
+            return a->priority < b->priority;
+        }
+        return a->seq < b->seq;
+    }
+};
+
+class GDSFEviction : public CacheEviction {
+    private:
+        const EmConfItems* sci;
+
+        std::unordered_map<std::string, GDSFEvictionEntry*> _mapping;
+        IndexedHeap<GDSFEvictionEntry, GDSFLess> heap;
+        GDSFCost cost_mode;
+        double clock; // the priority of the last eviction
+        unsigned long long seq;
+
+        unsigned long long current_size;
+        unsigned long long total_capacity;
+        std::string cache_id; // k=kernel, h=hdd
+
+        // Reset every periodic_output
+        unsigned long evicted;
+        unsigned long long evicted_bytes;
+        double evicted_cost;
+        unsigned long long hit_bytes;
+        double saved_cost; // cost of the hits, i.e. origin cost avoided
+
+        double fetch_cost(const std::string& customer_id, unsigned long data) const;
+        inline double priority(const GDSFEvictionEntry* node) const {
+            return clock + (double) node->count * node->cost / (node->data ? node->data : 1);
+        }
+
+    public:
+        GDSFEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+        ~GDSFEviction();
+
+        void hourly_purging(unsigned long timestamp);
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        /*
+         * evicts the lowest priority entry
+         */
+        bool purge_regular();
+        // lowest priority first, from the top of the heap
+        bool peek_victims(unsigned long long incoming, size_t max_victims,
+                          std::vector<std::pair<std::string, unsigned long> >& victims);
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+#endif /* GDSF_EVICTION_H_ */
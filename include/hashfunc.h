@@ -81,4 +81,274 @@ inline uint64_t bkdr_hash_64_2_ind(const char* str1, unsigned int ind)
 }
 
 
+inline uint64_t rotl64(uint64_t x, int8_t r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+/// MurmurHash3_x64_128 (Austin Appleby, public domain), one pass for 128 bits
+inline void murmur3_128(const char* key, size_t len, uint32_t seed, uint64_t out[2])
+{
+    const uint8_t* data = (const uint8_t*) key;
+    const size_t nblocks = len / 16;
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    for (size_t i = 0; i < nblocks; i++) {
+        uint64_t k1, k2;
+        memcpy(&k1, data + i * 16, sizeof(k1));
+        memcpy(&k2, data + i * 16 + 8, sizeof(k2));
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const uint8_t* tail = data + nblocks * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+
+    switch (len & 15) {
+        case 15: k2 ^= ((uint64_t) tail[14]) << 48;
+        case 14: k2 ^= ((uint64_t) tail[13]) << 40;
+        case 13: k2 ^= ((uint64_t) tail[12]) << 32;
+        case 12: k2 ^= ((uint64_t) tail[11]) << 24;
+        case 11: k2 ^= ((uint64_t) tail[10]) << 16;
+        case 10: k2 ^= ((uint64_t) tail[ 9]) << 8;
+        case  9: k2 ^= ((uint64_t) tail[ 8]) << 0;
+                 k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+
+        case  8: k1 ^= ((uint64_t) tail[ 7]) << 56;
+        case  7: k1 ^= ((uint64_t) tail[ 6]) << 48;
+        case  6: k1 ^= ((uint64_t) tail[ 5]) << 40;
+        case  5: k1 ^= ((uint64_t) tail[ 4]) << 32;
+        case  4: k1 ^= ((uint64_t) tail[ 3]) << 24;
+        case  3: k1 ^= ((uint64_t) tail[ 2]) << 16;
+        case  2: k1 ^= ((uint64_t) tail[ 1]) << 8;
+        case  1: k1 ^= ((uint64_t) tail[ 0]) << 0;
+                 k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= len; h2 ^= len;
+    h1 += h2; h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2; h2 += h1;
+
+    out[0] = h1;
+    out[1] = h2;
+}
+
+/*
+ * Hash family
+ *
+ * One signature for the 64 bit string hashes so admission and index code
+ * can be handed any of them, see find_hash() and bin/hash_bench. All take
+ * an explicit length, so keys need not be NUL terminated.
+ */
+typedef uint64_t (*hash64_fn)(const char* key, size_t len, uint64_t seed);
+
+/// bkdr_hash_64_2_ind() with the seed as the starting value, as a baseline
+inline uint64_t bkdr_64(const char* key, size_t len, uint64_t seed)
+{
+    uint64_t hash = seed;
+    for (size_t i = 0; i < len; i++)
+        hash = (hash * 131) + key[i];
+    return hash;
+}
+
+/// FNV-1a, one multiply per byte
+inline uint64_t fnv1a_64(const char* key, size_t len, uint64_t seed)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL ^ seed;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t) key[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/// First half of murmur3_128()
+inline uint64_t murmur3_64(const char* key, size_t len, uint64_t seed)
+{
+    uint64_t h[2];
+    murmur3_128(key, len, (uint32_t) seed, h);
+    return h[0];
+}
+
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+inline uint64_t read64(const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return v; }
+inline uint64_t read32(const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+
+inline uint64_t xxh64_round(uint64_t acc, uint64_t input)
+{
+    acc += input * XXH_PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+inline uint64_t xxh64_merge(uint64_t acc, uint64_t val)
+{
+    acc ^= xxh64_round(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+/// XXH64 (Yann Collet, BSD), 32 bytes per round in four lanes
+inline uint64_t xxh64(const char* key, size_t len, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*) key;
+    const uint8_t* end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        uint64_t v2 = seed + XXH_PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME64_1;
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = xxh64_round(v1, read64(p)); p += 8;
+            v2 = xxh64_round(v2, read64(p)); p += 8;
+            v3 = xxh64_round(v3, read64(p)); p += 8;
+            v4 = xxh64_round(v4, read64(p)); p += 8;
+        } while (p <= limit);
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh64_merge(h, v1);
+        h = xxh64_merge(h, v2);
+        h = xxh64_merge(h, v3);
+        h = xxh64_merge(h, v4);
+    }
+    else {
+        h = seed + XXH_PRIME64_5;
+    }
+    h += len;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh64_round(0, read64(p));
+        h = rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        h ^= read32(p) * XXH_PRIME64_1;
+        h = rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        h ^= (*p) * XXH_PRIME64_5;
+        h = rotl64(h, 11) * XXH_PRIME64_1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+/// 64x64 -> 128 multiply, low half in a, high half in b
+inline void wymum(uint64_t* a, uint64_t* b)
+{
+    __uint128_t r = *a;
+    r *= *b;
+    *a = (uint64_t) r;
+    *b = (uint64_t) (r >> 64);
+}
+
+inline uint64_t wymix(uint64_t a, uint64_t b) { wymum(&a, &b); return a ^ b; }
+
+/// wyhash final4 (Wang Yi, public domain), 16 bytes per 128 bit multiply
+inline uint64_t wyhash(const char* key, size_t len, uint64_t seed)
+{
+    static const uint64_t secret[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+                                       0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+    const uint8_t* p = (const uint8_t*) key;
+    uint64_t a, b;
+
+    seed ^= wymix(seed ^ secret[0], secret[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (read32(p) << 32) | read32(p + ((len >> 3) << 2));
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0) {
+            a = (((uint64_t) p[0]) << 16) | (((uint64_t) p[len >> 1]) << 8) | p[len - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wymix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+                see1 = wymix(read64(p + 16) ^ secret[2], read64(p + 24) ^ see1);
+                see2 = wymix(read64(p + 32) ^ secret[3], read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wymix(read64(p) ^ secret[1], read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    wymum(&a, &b);
+    return wymix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+struct HashFamilyEntry
+{
+    const char* name;
+    hash64_fn fn;
+};
+
+static const HashFamilyEntry hash_family[] = {
+    {"bkdr", bkdr_64},
+    {"fnv1a", fnv1a_64},
+    {"murmur3", murmur3_64},
+    {"xxh64", xxh64},
+    {"wyhash", wyhash},
+};
+
+#define HASH_FAMILY_SIZE (sizeof(hash_family) / sizeof(hash_family[0]))
+
+/// Looks a hash up by name, NULL if unknown
+inline hash64_fn find_hash(const char* name)
+{
+    for (size_t i = 0; i < HASH_FAMILY_SIZE; i++) {
+        if (strcmp(hash_family[i].name, name) == 0)
+            return hash_family[i].fn;
+    }
+    return NULL;
+}
+
 #endif // _HASHFUNC_H_
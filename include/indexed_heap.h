@@ -0,0 +1,114 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Indexed d-ary min heap
+ *
+ * Holds pointers to T, which keeps its own position in heap_index so that
+ * update() and remove() find it in O(1) and fix the heap in O(log n). Less
+ * is any functor ordering two T*. A 4-ary heap is shallower than a binary
+ * one and its children sit in one cache line.
+ */
+
+#ifndef INDEXED_HEAP_H_
+#define INDEXED_HEAP_H_
+
+#include <assert.h>
+#include <stddef.h>
+#include <vector>
+
+#define INDEXED_HEAP_NONE ((size_t) -1)
+
+template <class T, class Less, unsigned int D = 4>
+class IndexedHeap {
+    private:
+        std::vector<T*> items;
+        Less less;
+
+        inline void place(size_t i, T* item) {
+            items[i] = item;
+            item->heap_index = i;
+        }
+
+        void sift_up(size_t i) {
+            T* item = items[i];
+            while (i > 0) {
+                size_t parent = (i - 1) / D;
+                if (!less(item, items[parent])) {
+                    break;
+                }
+                place(i, items[parent]);
+                i = parent;
+            }
+            place(i, item);
+        }
+
+        void sift_down(size_t i) {
+            T* item = items[i];
+            size_t n = items.size();
+            while (true) {
+                size_t first = i * D + 1;
+                if (first >= n) {
+                    break;
+                }
+                size_t last = first + D < n ? first + D : n;
+                size_t best = first;
+                for (size_t c = first + 1; c < last; c++) {
+                    if (less(items[c], items[best])) {
+                        best = c;
+                    }
+                }
+                if (!less(items[best], item)) {
+                    break;
+                }
+                place(i, items[best]);
+                i = best;
+            }
+            place(i, item);
+        }
+
+    public:
+        static const unsigned int arity = D;
+
+        inline bool empty() const           { return items.empty(); }
+        inline size_t size() const          { return items.size(); }
+        inline T* top() const               { assert(!items.empty()); return items[0]; }
+        /* i-th item in heap order, children of i are D*i+1 .. D*i+D */
+        inline T* at(size_t i) const        { return items[i]; }
+
+        void push(T* item) {
+            items.push_back(item);
+            sift_up(items.size() - 1);
+        }
+
+        T* pop() {
+            T* item = top();
+            remove(item);
+            return item;
+        }
+
+        /* Call after item's ordering key changed */
+        void update(T* item) {
+            size_t i = item->heap_index;
+            assert(i < items.size() && items[i] == item);
+            if (i > 0 && less(item, items[(i - 1) / D])) {
+                sift_up(i);
+            } else {
+                sift_down(i);
+            }
+        }
+
+        void remove(T* item) {
+            size_t i = item->heap_index;
+            assert(i < items.size() && items[i] == item);
+            T* last = items.back();
+            items.pop_back();
+            item->heap_index = INDEXED_HEAP_NONE;
+            if (last != item) {
+                place(i, last);
+                update(last);
+            }
+        }
+};
+
+#endif /* INDEXED_HEAP_H_ */
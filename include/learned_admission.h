@@ -0,0 +1,117 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Learned admission
+ *
+ * An online logistic regression predicts whether a missed object will be
+ * requested again soon. Admission goes to those predicted at
+ * learned_admission_threshold (-A) or more. The features are one-hot and
+ * hashed into LEARNED_ADMISSION_WEIGHTS weights: size class (log2), customer,
+ * content class, requests seen and requests since the last one (both log2
+ * buckets), and a few crosses of those. Scoring and every update are a fixed
+ * LEARNED_ADMISSION_FEATURES weights, so the cost per request is bounded.
+ *
+ * Every decision is labelled later, with one SGD step:
+ *  - admitted and hit: 1
+ *  - admitted and missed again, i.e. evicted first: 0 (a wasted write)
+ *  - rejected and requested again: 1 (a missed hit)
+ *  - either with no request within the horizon: 0
+ * The horizon is learned_admission_window (-V) requests. It should be about
+ * as long as the cache keeps an object, so with -V 0 it follows the cache:
+ * the longest gap between two requests of a key that still hit, fading by
+ * 1/e every LEARNED_ADMISSION_HORIZON_DECAY hits.
+ *
+ * Keys are remembered by fingerprint for LEARNED_ADMISSION_MEMORY horizons
+ * after their last request. Until LEARNED_ADMISSION_WARMUP labels are in, a
+ * key is admitted on its second request, like second-hit caching.
+ */
+
+#ifndef LEARNED_ADMISSION_H_
+#define LEARNED_ADMISSION_H_
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "cache_policy.h"
+#include "hashfunc.h"
+#include "ring_buffer.h"
+
+#define LEARNED_ADMISSION_WEIGHTS (1 << 16)
+#define LEARNED_ADMISSION_FEATURES 9
+#define LEARNED_ADMISSION_WARMUP 1024
+#define LEARNED_ADMISSION_RATE 0.05
+#define LEARNED_ADMISSION_MIN_HORIZON 256 // requests
+#define LEARNED_ADMISSION_HORIZON_DECAY 1024 // hits for the horizon to shrink by 1/e
+#define LEARNED_ADMISSION_MEMORY 4 // horizons keys are remembered for
+#define LEARNED_ADMISSION_HASH_SEED 0x1ea4ed
+
+struct LearnedAdmissionEntry
+{
+    unsigned long count; // requests while remembered
+    unsigned long long last_request;
+    unsigned int events; // requests still remembered
+    bool pending; // decision waiting for its label
+    bool admitted;
+    unsigned long long deadline; // labelled 0 if still pending then
+    uint32_t features[LEARNED_ADMISSION_FEATURES]; // weight indexes at the decision
+};
+
+struct LearnedAdmissionEvent
+{
+    uint64_t fingerprint;
+    unsigned long long time;
+};
+
+class LearnedAdmission : public CacheAdmission {
+    private:
+        std::vector<std::string> no_bf_cust;
+
+        std::unordered_map<uint64_t, LearnedAdmissionEntry> keys;
+        RingBuffer<LearnedAdmissionEvent> window; // requests, oldest first
+        RingBuffer<LearnedAdmissionEvent> decisions; // by deadline, oldest first
+        std::vector<float> weights;
+        unsigned long long now; // requests seen
+        double horizon; // requests a decision waits for its label
+        bool auto_horizon;
+        unsigned long long labels;
+        double threshold;
+
+        // Reset every periodic_output
+        unsigned long admitted;
+        unsigned long rejected;
+        unsigned long admitted_hit;
+        unsigned long admitted_wasted;
+        unsigned long rejected_back;
+        unsigned long rejected_gone;
+        double loss; // log loss of the labels
+        unsigned long long check_ns;
+
+        static inline uint64_t fingerprint(const std::string& s) {
+            return wyhash(s.data(), s.size(), LEARNED_ADMISSION_HASH_SEED);
+        }
+        void featurize(const LearnedAdmissionEntry& entry, unsigned long long size,
+                       const std::string& key, const std::string& customer_id, uint32_t* features) const;
+        float predict(const uint32_t* features) const;
+        void learn(LearnedAdmissionEntry& entry, bool positive);
+        /* Counts a request for the key and labels or forgets what is past due */
+        void note(LearnedAdmissionEntry& entry, uint64_t fp);
+
+    public:
+        LearnedAdmission(double threshold, unsigned long window_size,
+                         std::vector<std::string> no_bf_cust);
+        ~LearnedAdmission();
+
+        bool check(std::string key, unsigned long data, unsigned long long size,
+                   unsigned long ts, std::string customer_id_str);
+        void record_hit(const std::string& key, unsigned long long size,
+                        unsigned long ts, const std::string& customer_id_str);
+        bool check_customer_in_list(std::string custid) const;
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+#endif /* LEARNED_ADMISSION_H_ */
@@ -0,0 +1,108 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Least Hit Density (LHD) Cache Eviction Policy
+ *
+ * Evicts the entry expected to bring the fewest hits per byte per unit of
+ * time it would still take up: hit density = P(hit) / (size * expected
+ * remaining lifetime). Both come from how old (in requests since the last
+ * access, coarsened into LHD_MAX_AGE buckets) entries of the same class were
+ * when they were hit or evicted. Classes are by request count and log2(size).
+ *
+ * Hits and evictions are counted as they happen; the densities are rebuilt
+ * from the counts every hourly_purging (the counts decaying by LHD_EWMA_DECAY
+ * each time), so the cache must be created with hourly purging on. Victims
+ * are the lowest density of eviction_samples random entries, as in
+ * SampledEviction.
+ */
+
+#ifndef LHD_EVICTION_H_
+#define LHD_EVICTION_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define LHD_MAX_AGE 4096 // age buckets per class
+#define LHD_REF_CLASSES 4 // 1, 2-3, 4-7, 8+ requests
+#define LHD_SIZE_CLASSES 8 // log2(size) / 2 from 1KB, 2 octaves each
+#define LHD_MIN_SIZE_LOG2 10
+#define LHD_CLASSES (LHD_REF_CLASSES * LHD_SIZE_CLASSES)
+#define LHD_EWMA_DECAY 0.9
+#define LHD_MAX_OVERFLOW 0.01 // share of events past the last bucket before ages are coarsened
+
+struct LHDEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    unsigned long data;
+    unsigned long timestamp; // last request
+    unsigned long count; // keep track of request count
+    unsigned long long last_access; // in requests seen by the policy
+    size_t slot; // position in LHDEviction::entries
+};
+
+struct LHDClass
+{
+    std::vector<double> hits; // per age bucket, decayed
+    std::vector<double> evictions;
+    std::vector<double> density; // per age bucket, from the two above
+};
+
+class LHDEviction : public CacheEviction {
+    private:
+        const EmConfItems* sci;
+
+        std::unordered_map<std::string, LHDEvictionEntry*> _mapping;
+        std::vector<LHDEvictionEntry*> entries;
+        std::vector<LHDClass> classes;
+        unsigned int sample_count; // K
+        unsigned long long now; // requests seen
+        unsigned int age_shift; // age bucket = requests since last access >> age_shift
+        unsigned long long overflows; // events that fell in the last bucket since reconfigure
+        unsigned long long events;
+
+        unsigned long long current_size;
+        unsigned long long total_capacity;
+        std::string cache_id; // k=kernel, h=hdd
+
+        // Reset every periodic_output
+        unsigned long evicted;
+        unsigned long long evicted_bytes;
+        double evicted_density_sum;
+        unsigned long reconfigurations;
+
+        unsigned int class_of(const LHDEvictionEntry* node) const;
+        unsigned int age_of(const LHDEvictionEntry* node);
+        double density_of(const LHDEvictionEntry* node);
+        void reconfigure();
+        void coarsen_ages();
+        void evict(LHDEvictionEntry* node);
+
+    public:
+        LHDEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+        ~LHDEviction();
+
+        /*
+         * Rebuilds the hit densities, no purging
+         */
+        void hourly_purging(unsigned long timestamp);
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        /*
+         * evicts the lowest hit density of sample_count random entries
+         */
+        bool purge_regular();
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+#endif /* LHD_EVICTION_H_ */
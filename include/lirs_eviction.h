@@ -0,0 +1,112 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * LIRS Cache Eviction Policy, in bytes
+ *
+ * Ranks objects by reuse distance instead of recency. LIR objects (short
+ * reuse distance) get all but lirs_hir_share (-I) of the bytes and are only
+ * evicted by being demoted to HIR. New and long reuse distance objects are
+ * resident HIR and leave first, in FIFO order, so a scan of objects requested
+ * once only ever churns the small HIR part.
+ *
+ * The stack S holds the LIR objects and every HIR object (resident or not)
+ * requested more recently than the oldest LIR one, which is always at the
+ * bottom. A HIR object requested while still in S has a shorter reuse
+ * distance than that LIR one and takes its place. Non resident HIR entries
+ * are only kept for this; there are never more of them than
+ * LIRS_NONRESIDENT_FACTOR times the resident objects.
+ */
+
+#ifndef LIRS_EVICTION_H_
+#define LIRS_EVICTION_H_
+
+#include <string>
+#include <unordered_map>
+
+#define LIRS_NONRESIDENT_FACTOR 2
+
+enum LIRSState { LIRS_LIR, LIRS_HIR, LIRS_NONRESIDENT };
+
+struct LIRSEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    unsigned long data;
+    unsigned long timestamp;
+    unsigned long count; // keep track of request count
+    LIRSState state;
+    bool in_stack;
+    LIRSEvictionEntry* s_prev; // stack S, top first
+    LIRSEvictionEntry* s_next;
+    LIRSEvictionEntry* q_prev; // resident HIR queue Q, or the non resident list
+    LIRSEvictionEntry* q_next;
+};
+
+class LIRSEviction : public CacheEviction {
+    private:
+        const EmConfItems* sci;
+
+        std::unordered_map<std::string, LIRSEvictionEntry*> _mapping; // non resident too
+        LIRSEvictionEntry* s_top; // sentinels
+        LIRSEvictionEntry* s_bottom;
+        LIRSEvictionEntry* q_head; // oldest, next to go
+        LIRSEvictionEntry* q_tail;
+        LIRSEvictionEntry* nr_head; // oldest non resident
+        LIRSEvictionEntry* nr_tail;
+
+        unsigned long long current_size;
+        unsigned long long total_capacity;
+        unsigned long long lir_capacity;
+        unsigned long long lir_bytes;
+        unsigned long long hir_bytes;
+        unsigned long long lir_items;
+        unsigned long long hir_items;
+        unsigned long long nonresident_items;
+        unsigned long long stack_items;
+        std::string cache_id; // k=kernel, h=hdd
+
+        // Reset every periodic_output
+        unsigned long lir_hits;
+        unsigned long hir_hits;
+        unsigned long nonresident_hits; // misses that came back as LIR
+        unsigned long demoted;
+        unsigned long evicted;
+
+        void stack_push_top(LIRSEvictionEntry* node);
+        void stack_remove(LIRSEvictionEntry* node);
+        void list_push_back(LIRSEvictionEntry* node, LIRSEvictionEntry* tail);
+        void list_remove(LIRSEvictionEntry* node);
+
+        /* Pops non LIR entries off the bottom of S */
+        void prune();
+        /* Bottom LIR entry becomes resident HIR at the end of Q */
+        void demote_bottom();
+        void make_lir(LIRSEvictionEntry* node);
+        void forget(LIRSEvictionEntry* node);
+        void trim_nonresident();
+
+    public:
+        LIRSEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+        ~LIRSEviction();
+
+        void hourly_purging(unsigned long timestamp);
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        /*
+         * evicts the oldest resident HIR, demoting the bottom LIR first if
+         * there is none
+         */
+        bool purge_regular();
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+#endif /* LIRS_EVICTION_H_ */
@@ -0,0 +1,145 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Learned Cache Eviction Policy, in bytes (after learning relaxed Belady)
+ *
+ * Learns the time to the next request of an object from its features: the
+ * requests since its last one (age), the gaps between its last LRB_DELTAS
+ * requests, its size, customer and the class of its extension. To evict,
+ * eviction_samples random entries are scored and the one predicted to come
+ * back last goes, so the policy imitates Belady with a bounded horizon.
+ * Until the first model is in, the oldest sample goes (sampled LRU).
+ *
+ * Time is counted in requests seen by the policy. Objects requested within
+ * the last lrb_window (-M) requests are remembered, cached or not. On every
+ * request one random cached entry is sampled: its features now, labelled
+ * with log2(1 + requests until it is next requested), or 2 x lrb_window if
+ * it is not within the window. Every LRB_TRAIN_SAMPLES labels a new model
+ * is trained on a background thread. It is only put in use when the next
+ * batch is full (waiting for it if need be), so runs stay reproducible.
+ *
+ * Feature extraction and inference are timed and reported next to the
+ * training time and error, to weigh the model's cost against its hits.
+ */
+
+#ifndef LRB_EVICTION_H_
+#define LRB_EVICTION_H_
+
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "gbt.h"
+#include "ring_buffer.h"
+
+#define LRB_DELTAS 8
+#define LRB_FEATURES (LRB_DELTAS + 4) // age, deltas, size, customer, extension
+#define LRB_TRAIN_SAMPLES 8192
+#define LRB_TREES 32
+#define LRB_DEPTH 5
+#define LRB_MIN_LEAF 32
+#define LRB_LEARNING_RATE 0.1
+#define LRB_HASH_SEED 0x1eb1eb1e
+
+struct LRBEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    unsigned long data;
+    unsigned long timestamp;
+    unsigned long count; // requests since it entered the window
+    unsigned long long last_access; // in requests seen by the policy
+    unsigned int deltas[LRB_DELTAS]; // gaps between the last requests, newest first
+    float customer; // customer id feature, hashed
+    float extension; // ContentClass
+    bool cached;
+    size_t slot; // position in LRBEviction::entries while cached
+    unsigned int events; // window events pointing here, freed at 0 unless cached
+    bool pending; // has a sample waiting for its label
+    unsigned long long sample_time;
+    float sample[LRB_FEATURES];
+};
+
+struct LRBWindowEvent
+{
+    LRBEvictionEntry* node;
+    unsigned long long time;
+    bool sample; // else a request
+};
+
+/* One batch, handed to the training thread */
+struct LRBTraining
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    GBTModel model;
+    double rmse;
+    double train_ms;
+};
+
+class LRBEviction : public CacheEviction {
+    private:
+        const EmConfItems* sci;
+
+        std::unordered_map<std::string, LRBEvictionEntry*> _mapping; // the window, cached or not
+        std::vector<LRBEvictionEntry*> entries; // cached
+        RingBuffer<LRBWindowEvent> window; // oldest first
+        unsigned long long now; // requests seen
+        unsigned long long window_size;
+        unsigned int sample_count; // K
+
+        GBTModel model; // in use
+        std::vector<float> batch_x; // labelled samples being collected
+        std::vector<float> batch_y;
+        LRBTraining* training; // on the thread, NULL if none
+        std::thread trainer;
+
+        unsigned long long current_size;
+        unsigned long long total_capacity;
+        std::string cache_id; // k=kernel, h=hdd
+
+        // Reset every periodic_output
+        unsigned long evicted;
+        unsigned long long features; // rows extracted, samples and candidates
+        unsigned long long feature_ns;
+        unsigned long long inferences;
+        unsigned long long inference_ns;
+        unsigned long trainings; // models put in use
+        double train_ms;
+        double train_rmse; // of the last one
+
+        void extract(const LRBEvictionEntry* node, float* row);
+        /* Accounts for a request: labels, history, sampling, window */
+        void touch(LRBEvictionEntry* node);
+        void label(LRBEvictionEntry* node, unsigned long long distance);
+        void sample_one();
+        void expire();
+        /* Puts the last model in use and trains on the full batch */
+        void submit();
+
+    public:
+        LRBEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+        ~LRBEviction();
+
+        void hourly_purging(unsigned long timestamp);
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        /*
+         * evicts the one of sample_count random entries predicted to be
+         * requested again last
+         */
+        bool purge_regular();
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+#endif /* LRB_EVICTION_H_ */
@@ -88,6 +88,9 @@ class LRUEviction : public CacheEviction {
         int check(std::string key, unsigned long ts);
         // default purge: we delete the least recently requested file
         bool purge_regular();
+        // least recently requested first
+        bool peek_victims(unsigned long long incoming, size_t max_victims,
+                          std::vector<std::pair<std::string, unsigned long> >& victims);
 
 
         unsigned long long get_size();
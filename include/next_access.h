@@ -0,0 +1,63 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Next access annotation for offline policies
+ *
+ * Reads the whole trace first, copying it to a spill file to replay it, and
+ * keeps a 64 bit fingerprint of the cache key of every processed line. A
+ * reverse pass over the fingerprints then gives every request the index of
+ * the next one for the same key (NEXT_ACCESS_NEVER if none). Both arrays are
+ * held NEXT_ACCESS_CHUNK records at a time, the rest goes to spill files so
+ * only the distinct keys have to fit in memory.
+ *
+ * Lines are parsed with Emulator::parse_access_log_line, so the requests
+ * line up with the ones the replay processes. Spill files go to $TMPDIR
+ * (/tmp if unset) and are removed once open.
+ */
+
+#ifndef NEXT_ACCESS_H_
+#define NEXT_ACCESS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define NEXT_ACCESS_CHUNK (1 << 22) // records in memory, 32 MB
+#define NEXT_ACCESS_HASH_SEED 0x6e657874
+
+class Emulator;
+
+class NextAccessOracle {
+    private:
+        std::string spill_dir;
+        std::ifstream trace_in; // the spilled trace
+        FILE* keys; // fingerprints, only written past one chunk
+        FILE* nexts;
+        std::vector<uint64_t> next_chunk; // the one next() is in
+        unsigned long long requests; // processed lines
+        unsigned long long served; // handed out by next()
+
+        FILE* open_spill(std::string& path);
+        void read_records(FILE* f, unsigned long long first, std::vector<uint64_t>& records);
+        void write_records(FILE* f, unsigned long long first, const std::vector<uint64_t>& records);
+
+    public:
+        NextAccessOracle();
+        ~NextAccessOracle();
+
+        /* Reads all of in and works out the next accesses, see above */
+        void annotate(std::istream& in, Emulator* em);
+        /* The trace again, to feed Emulator::populate_access_log_cache */
+        std::istream& trace();
+
+        /* Index and next access of the following processed line */
+        void next(unsigned long long& request, unsigned long long& next_access);
+
+        inline unsigned long long get_requests() const { return requests; }
+};
+
+#endif /* NEXT_ACCESS_H_ */
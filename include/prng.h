@@ -0,0 +1,67 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Per-instance pseudo random numbers
+ *
+ * xoshiro256** (Blackman and Vigna, public domain), seeded through
+ * splitmix64 so that nearby seeds give unrelated streams. Every admission
+ * and eviction policy owns one (see cache_policy.h), so a run is repeatable
+ * for a given seed no matter how many caches share the process.
+ */
+
+#ifndef PRNG_H_
+#define PRNG_H_
+
+#include <stdint.h>
+
+/// splitmix64 step, advances x
+inline uint64_t splitmix64(uint64_t& x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+class Prng {
+    private:
+        uint64_t s[4];
+
+        static inline uint64_t rotl(uint64_t x, int k) {
+            return (x << k) | (x >> (64 - k));
+        }
+
+    public:
+        Prng()                  { seed(0); }
+        Prng(uint64_t _seed)    { seed(_seed); }
+
+        void seed(uint64_t _seed) {
+            for (int i = 0; i < 4; i++)
+                s[i] = splitmix64(_seed);
+        }
+
+        inline uint64_t next() {
+            uint64_t result = rotl(s[1] * 5, 7) * 9;
+            uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+            return result;
+        }
+
+        /// Uniform in [0, 1), 53 bits
+        inline double uniform() {
+            return (next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        /// Uniform in [0, n), multiply-shift instead of a division
+        inline uint64_t below(uint64_t n) {
+            return (uint64_t) (((__uint128_t) next() * n) >> 64);
+        }
+};
+
+#endif /* PRNG_H_ */
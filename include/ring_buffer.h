@@ -0,0 +1,68 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Growable FIFO ring buffer
+ *
+ * Power of 2 capacity, doubled (and unwrapped) when full, so push_back and
+ * pop_front are O(1) amortized with no per-element allocation.
+ */
+
+#ifndef RING_BUFFER_H_
+#define RING_BUFFER_H_
+
+#include <assert.h>
+#include <stddef.h>
+#include <vector>
+
+template <class T>
+class RingBuffer {
+    private:
+        std::vector<T> slots;
+        size_t head; // index of the front element
+        size_t count;
+
+        void grow() {
+            std::vector<T> bigger(slots.size() * 2);
+            for (size_t i = 0; i < count; i++) {
+                bigger[i] = slots[(head + i) & (slots.size() - 1)];
+            }
+            slots.swap(bigger);
+            head = 0;
+        }
+
+    public:
+        RingBuffer(size_t initial = 16) : head(0), count(0) {
+            size_t cap = 1;
+            while (cap < initial) {
+                cap <<= 1;
+            }
+            slots.resize(cap);
+        }
+
+        inline bool empty() const           { return count == 0; }
+        inline size_t size() const          { return count; }
+
+        inline void push_back(const T& v) {
+            if (count == slots.size()) {
+                grow();
+            }
+            slots[(head + count) & (slots.size() - 1)] = v;
+            count++;
+        }
+
+        inline T& front() {
+            assert(count > 0);
+            return slots[head];
+        }
+
+        inline T pop_front() {
+            assert(count > 0);
+            T v = slots[head];
+            head = (head + 1) & (slots.size() - 1);
+            count--;
+            return v;
+        }
+};
+
+#endif /* RING_BUFFER_H_ */
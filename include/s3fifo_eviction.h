@@ -0,0 +1,109 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * S3-FIFO Cache Eviction Policy
+ *
+ * Three FIFO queues: a small probationary one (S3FIFO_SMALL_SHARE of the
+ * bytes) that every new object enters, a main one for the rest, and a ghost
+ * queue remembering the hashes of keys recently evicted from the small
+ * queue. A hit only bumps a 2 bit frequency, nothing moves.
+ *
+ * When the small queue is over its share its oldest entry moves to main if
+ * it was hit since insertion, else it is evicted and remembered as a ghost.
+ * The oldest main entry is put back at the end with its frequency decreased
+ * while it is non zero, else evicted. A miss on a ghost key goes straight
+ * into main. The queues are ring buffers of entry pointers.
+ */
+
+#ifndef S3FIFO_EVICTION_H_
+#define S3FIFO_EVICTION_H_
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+
+#include "hashfunc.h"
+#include "ring_buffer.h"
+
+#define S3FIFO_SMALL_SHARE 0.1
+#define S3FIFO_MOVE_TO_MAIN 1 // hits in small needed to move to main
+#define S3FIFO_MAX_FREQ 3
+#define S3FIFO_HASH_SEED 0x5f3f1f0f
+
+struct S3FIFOEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    unsigned long data;
+    unsigned long timestamp;
+    unsigned long count; // keep track of request count
+    unsigned char freq; // hits, capped at S3FIFO_MAX_FREQ
+    bool in_main;
+};
+
+struct S3FIFOGhost
+{
+    uint64_t hash;
+    unsigned long long seq; // matches ghost_index while this is the live copy
+};
+
+class S3FIFOEviction : public CacheEviction {
+    private:
+        const EmConfItems* sci;
+
+        std::unordered_map<std::string, S3FIFOEvictionEntry*> _mapping;
+        RingBuffer<S3FIFOEvictionEntry*> small;
+        RingBuffer<S3FIFOEvictionEntry*> main;
+        RingBuffer<S3FIFOGhost> ghost;
+        std::unordered_map<uint64_t, unsigned long long> ghost_index; // hash -> seq
+        unsigned long long ghost_seq;
+
+        unsigned long long current_size;
+        unsigned long long total_capacity;
+        unsigned long long small_capacity;
+        unsigned long long small_bytes;
+        unsigned long long main_bytes;
+        std::string cache_id; // k=kernel, h=hdd
+
+        // Reset every periodic_output
+        unsigned long small_hits;
+        unsigned long main_hits;
+        unsigned long promoted; // small -> main
+        unsigned long reinserted; // main -> main
+        unsigned long ghost_hits;
+        unsigned long evicted_small;
+        unsigned long evicted_main;
+
+        static inline uint64_t key_hash(const std::string& key) {
+            return wyhash(key.data(), key.size(), S3FIFO_HASH_SEED);
+        }
+        void remember_ghost(uint64_t hash);
+        bool take_ghost(uint64_t hash);
+        void evict_small();
+        void evict_main();
+        void evict(S3FIFOEvictionEntry* node);
+
+    public:
+        S3FIFOEviction(unsigned long long size, std::string id, const EmConfItems * sci);
+        ~S3FIFOEviction();
+
+        void hourly_purging(unsigned long timestamp);
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        /*
+         * evicts one entry, from small while it is over its share
+         */
+        bool purge_regular();
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+#endif /* S3FIFO_EVICTION_H_ */
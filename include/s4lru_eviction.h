@@ -9,6 +9,8 @@
 #ifndef S4LRU_EVICTION_H_
 #define S4LRU_EVICTION_H_
 
+#include <vector>
+
 struct S4LRUEvictionEntry
 {
     std::string key; // hash key
@@ -25,6 +27,25 @@ struct S4LRUEvictionEntry
     S4LRUEvictionEntry* next;
 };
 
+/*
+ * One LRU segment. Segment 0 takes new entries, a hit moves an entry up one
+ * segment and an overflowing segment pushes its tail down one (out of the
+ * cache from segment 0).
+ */
+struct S4LRUSegment
+{
+    S4LRUEvictionEntry* head;
+    S4LRUEvictionEntry* tail;
+    unsigned long long bytes;
+    unsigned long long capacity;
+
+    // Reset every periodic_output
+    unsigned long hits;
+    unsigned long long hit_bytes;
+    unsigned long promoted; // entered from below (new entries for segment 0)
+    unsigned long demoted;  // pushed out of the bottom (evictions for segment 0)
+};
+
 
 
 class S4LRUEviction : public CacheEviction {
@@ -34,16 +55,12 @@ class S4LRUEviction : public CacheEviction {
         std::unordered_map< std::string, S4LRUEvictionEntry*>	_mapping;
         std::vector<unsigned int>			avg_oldest_requested_file_vector;
 
-        unsigned long long*				current_size;
         unsigned long long				total_capacity;
 
-
         /* Now instead of a just H/T, we need one for each queue */
         unsigned short                  queue_count;
-
-
-        S4LRUEvictionEntry**		    head;
-        S4LRUEvictionEntry**		    tail;
+        std::vector<S4LRUSegment>       segments;
+        std::vector<double>             segment_shares;
 
 
         std::string						cache_id; // k=kernel, h=hdd
@@ -77,6 +94,12 @@ class S4LRUEviction : public CacheEviction {
     public:
         S4LRUEviction(unsigned long long size, unsigned short queue_count,
                       std::string id, const EmConfItems * sci);
+        /*
+         * One segment per share, segment i gets size * shares[i] / sum(shares)
+         * bytes. Segment 0 is the probationary one.
+         */
+        S4LRUEviction(unsigned long long size, std::vector<double> shares,
+                      std::string id, const EmConfItems * sci);
         ~S4LRUEviction();
 
         /*
@@ -98,6 +121,9 @@ class S4LRUEviction : public CacheEviction {
          * default purge: we delete the least recently requested file
          */
         bool purge_regular();
+        // new entries go to segment 0, so its tail is what goes
+        bool peek_victims(unsigned long long incoming, size_t max_victims,
+                          std::vector<std::pair<std::string, unsigned long> >& victims);
 
         unsigned long long get_size();
         unsigned long long get_total_capacity();
@@ -112,10 +138,21 @@ class S4LRUEviction : public CacheEviction {
         void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
 
     private:
+        void init(unsigned long long size, std::vector<double> shares,
+                  std::string id, const EmConfItems * sci);
+        void set_segment_capacities();
 
         void attach(S4LRUEvictionEntry* node, unsigned short queue);
         void detach(S4LRUEvictionEntry* node);
 
+        /*
+         * Only the segment that just grew and the ones below it can be over
+         * capacity, so walk down from there and stop at the first segment
+         * that still fits.
+         */
+        void cascade(unsigned short queue);
+        void evict(S4LRUEvictionEntry* node);
+
         void purge_size_based_multimap();
 
         /*
@@ -0,0 +1,140 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Sampled (K random candidates) Cache Eviction Policy
+ *
+ * Entries live in a dense array. To evict, K random entries are scored by a
+ * SampleScorer and the one with the highest score goes, so any scoring
+ * formula costs O(K) per eviction instead of keeping the whole cache ordered.
+ */
+
+#ifndef SAMPLED_EVICTION_H_
+#define SAMPLED_EVICTION_H_
+
+#include <vector>
+
+struct SampledEvictionEntry
+{
+    std::string key; // hash key
+    std::string customer_id;
+    std::string orig_url; // original URL
+    unsigned long data;
+    unsigned long timestamp; // last request
+    unsigned long inserted;
+    unsigned long count; // keep track of request count
+    size_t slot; // position in SampledEviction::entries
+};
+
+/* What a scorer may look at besides the entry itself */
+struct SampleContext
+{
+    unsigned long now; // latest timestamp seen by the cache
+    unsigned long age_range; // oldest age in the current sample
+    double size_mu, size_var; // running mean/variance of log2(size)
+    long hour_count;
+};
+
+/* Higher score = evicted sooner */
+class SampleScorer {
+    public:
+        virtual ~SampleScorer();
+        virtual double score(const SampledEvictionEntry* node, const SampleContext& ctx)=0;
+        virtual std::string get_name()=0;
+};
+
+/*
+ * The CostLRUEviction formulas (eviction_formula, ef4_y, ef4_e, w_size,
+ * w_age), with the age range taken from the sample instead of the cache
+ */
+class FormulaScorer : public SampleScorer {
+    private:
+        const EmConfItems* sci;
+        int eviction_formula;
+        int ef4_y;
+        float ef4_e;
+        double w_size, w_age;
+
+    public:
+        FormulaScorer(const EmConfItems* sci, int eviction_formula, int ef4_y, float ef4_e);
+        double score(const SampledEvictionEntry* node, const SampleContext& ctx);
+        std::string get_name();
+};
+
+/* Oldest last request first, approximates LRU */
+class AgeScorer : public SampleScorer {
+    public:
+        double score(const SampledEvictionEntry* node, const SampleContext& ctx);
+        std::string get_name();
+};
+
+/* Lowest request rate since insertion first (hyperbolic caching) */
+class FrequencyScorer : public SampleScorer {
+    public:
+        double score(const SampledEvictionEntry* node, const SampleContext& ctx);
+        std::string get_name();
+};
+
+/* Age times size, big and cold first */
+class SizeAgeScorer : public SampleScorer {
+    public:
+        double score(const SampledEvictionEntry* node, const SampleContext& ctx);
+        std::string get_name();
+};
+
+/* Picks a scorer by name (sample_scorer), NULL if unknown */
+SampleScorer* make_sample_scorer(const std::string& name, const EmConfItems* sci);
+
+
+class SampledEviction : public CacheEviction {
+    private:
+        const EmConfItems* sci;
+        SampleScorer* scorer; // owned
+
+        std::unordered_map< std::string, SampledEvictionEntry*>	_mapping;
+        std::vector<SampledEvictionEntry*> entries;
+        std::vector<SampledEvictionEntry*> sample;
+
+        unsigned long long				current_size;
+        unsigned long long				total_capacity;
+        std::string						cache_id; // k=kernel, h=hdd
+        unsigned int					sample_count; // K
+        unsigned long					last_timestamp;
+        long							hour_count;
+
+        double							running_size_mu, running_size_var;
+        double							alpha_running_size_mu, alpha_running_size_var;
+
+        // Reset every periodic_output
+        unsigned long					evicted_count;
+        unsigned long long				evicted_bytes;
+        double							evicted_score_sum;
+
+    public:
+        SampledEviction(unsigned long long size, std::string id, const EmConfItems * sci,
+                        SampleScorer* scorer);
+        ~SampledEviction();
+
+        void hourly_purging(unsigned long timestamp);
+        unsigned long long put(std::string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out,
+                               std::string customer_id, std::string orig_url);
+        unsigned long get(std::string key, unsigned long ts, unsigned long bytes_out, std::string url_original);
+        int check(std::string key, unsigned long ts);	// to check if present.
+
+        /*
+         * scores sample_count random entries and evicts the highest
+         */
+        bool purge_regular();
+
+        unsigned long long get_size();
+        unsigned long long get_total_capacity();
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+
+    private:
+        void update_size_running_mean(unsigned long size);
+        void evict(SampledEvictionEntry* node);
+};
+
+#endif /* SAMPLED_EVICTION_H_ */
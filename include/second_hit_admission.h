@@ -11,6 +11,14 @@
 
 #include "bloomfilter.h"
 #include "cache_policy.h"
+#include "customer_thresholds.h"
+
+#ifdef BLOCKED_BF
+#include "blocked_bloomfilter.h"
+typedef BlockedBloomFilter AdmissionBloomFilter;
+#else
+typedef BloomFilter AdmissionBloomFilter;
+#endif
 
 /************************
  *
@@ -19,8 +27,9 @@
  ***********************/
 class SecondHitAdmission : public CacheAdmission {
     private:
-        BloomFilter * BF;
+        AdmissionBloomFilter * BF;
 	    std::vector<std::string> no_bf_cust;
+        const CustomerThresholds * customer_nval; // not owned, NULL: one N for all
 
     public:
         SecondHitAdmission(std::string file_name, size_t _nfuncs,
@@ -28,6 +37,11 @@ class SecondHitAdmission : public CacheAdmission {
                     std::vector<std::string> no_bf_cust);
         ~SecondHitAdmission();
 
+        /* Bloom filter hash by name (bkdr or one of hashfunc.h's hash_family) */
+        void set_hash(std::string hash_name);
+        /* Per customer N and max size, overrides the filter's N for listed customers */
+        void set_customer_nval(const CustomerThresholds* table);
+
         bool check(std::string key, unsigned long data, unsigned long long size,
                    unsigned long ts, std::string customer_id_str);
 	    bool check_customer_in_list(std::string custid) const;
@@ -39,27 +53,33 @@ class SecondHitAdmission : public CacheAdmission {
 
 /****************************
  * 
- * 2 Rotating Bloom Filters 
+ * Ring of rotating Bloom Filters 
+ *
+ * G generations share a window of 2 * max_age seconds (so G = 2 is the
+ * original pair of filters). Requests are added to the newest generation;
+ * when it is older than window / G the oldest one is cleared in place and
+ * becomes the newest. Lookups go newest first and stop at the first hit.
  *
  ****************************/
 
 struct BFEntry
 {
-    BloomFilter * BF;
+    AdmissionBloomFilter * BF;
     unsigned long int init_time;
-
-    BFEntry* next;
-
 };
 
 
 class SecondHitAdmissionRot : public CacheAdmission {
     private:
         unsigned long max_age;
+        unsigned long generation_span;
 
-        BFEntry * head;
+        std::vector<BFEntry> ring;
+        unsigned int newest; // index in ring
+        unsigned int live; // generations holding requests, newest first
 
 	    std::vector<std::string> no_bf_cust;
+        const CustomerThresholds * customer_nval; // not owned, NULL: one N for all
 
         /* Initialization stuff */
         std::string file_name;
@@ -67,18 +87,25 @@ class SecondHitAdmissionRot : public CacheAdmission {
         unsigned long bf_size;
         int _NVAL;
 
-/****************************
- * 
- * 2 Rotating Bloom Filters 
- *
- ****************************/
+        void init(unsigned int generations);
+        void rotate(unsigned long ts);
+
     public:
         SecondHitAdmissionRot(std::string file_name, size_t _nfuncs,
                     unsigned long size, int _NVAL,
                     std::vector<std::string> no_bf_cust,
                     unsigned long max_age);
+        SecondHitAdmissionRot(std::string file_name, size_t _nfuncs,
+                    unsigned long size, int _NVAL,
+                    std::vector<std::string> no_bf_cust,
+                    unsigned long max_age, unsigned int generations);
         ~SecondHitAdmissionRot();
 
+        /* Bloom filter hash by name (bkdr or one of hashfunc.h's hash_family) */
+        void set_hash(std::string hash_name);
+        /* Per customer N and max size, overrides the filter's N for listed customers */
+        void set_customer_nval(const CustomerThresholds* table);
+
         bool check(std::string key, unsigned long data, unsigned long long size,
                    unsigned long ts, std::string customer_id_str);
 	    bool check_customer_in_list(std::string custid) const;
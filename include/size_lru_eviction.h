@@ -9,6 +9,10 @@
 #ifndef SIZE_LRU_EVICTION_H_
 #define SIZE_LRU_EVICTION_H_
 
+#include <map>
+
+#include "customer_recency.h"
+
 struct s_item_attr
 {
     s_item_attr()
@@ -28,6 +32,15 @@ struct SizeLRUEvictionEntry
     unsigned long count; // keep track of request count
     SizeLRUEvictionEntry* prev;
     SizeLRUEvictionEntry* next;
+
+    // this customer's recency list (see customer_recency.h)
+    CustomerRecency<SizeLRUEvictionEntry>* cust;
+    SizeLRUEvictionEntry* cust_prev;
+    SizeLRUEvictionEntry* cust_next;
+
+    // position in the size based purge window (see refill_size_window)
+    bool in_window;
+    std::multimap<unsigned long, SizeLRUEvictionEntry*>::iterator window_it;
 };
 
 
@@ -37,6 +50,7 @@ class SizeLRUEviction : public CacheEviction {
         const EmConfItems* sci;
 
         std::unordered_map< std::string, SizeLRUEvictionEntry*>	_mapping;
+        CustomerRecencyIndex<SizeLRUEvictionEntry>	customer_recency;
         std::vector<unsigned int>			avg_oldest_requested_file_vector;
         unsigned long long				current_size;
         unsigned long long				total_capacity;
@@ -70,15 +84,17 @@ class SizeLRUEviction : public CacheEviction {
         double 							m_w_origin_cost, w_size, w_age, w_item_attr_val;
         std::unordered_map<std::string, s_item_attr> m_item_unordered_map;
 
+        // The purge_size_based_limit least recently used entries, ordered by
+        // size. Everything from window_front back to the tail is covered
+        // (window_front == tail when nothing is).
+        std::multimap<unsigned long, SizeLRUEvictionEntry*> size_window;
+        SizeLRUEvictionEntry*			window_front;
+        unsigned int					window_span;
+
         double							running_size_mu, running_size_var;
         double							alpha_running_size_mu, alpha_running_size_var;
         long							hour_count;
 
-        // Customer hit stats brought in here from emstructs and the old
-        // reporting variables objects
-	    std::unordered_map<std::string,
-		std::unordered_map<std::string, unsigned long> > customer_hit_stats;
-	    void compute_periodic_stats(bool floor_customer_loss);
 
 
     public:
@@ -123,15 +139,13 @@ class SizeLRUEviction : public CacheEviction {
         bool purge_regular();
         void weighted_purge();
         /*
-         * faster version (based on approximation)
-         * in progress
+         * customer_fair_eviction: evicts the oldest entry of the customer
+         * furthest over its byte budget (see customer_recency.h), plain LRU
+         * if every customer with cached entries is protected
          */
         void purge_customer_based_approx();
         /*
-         *
-         * this is the slow version. it is accurate.
-         * but very slow
-         * never ran this completely.
+         * purge_customer_based_approx() until we are back under capacity
          */
         void purge_customer_based();
         void dump_cache_contents(std::string filename);
@@ -157,15 +171,22 @@ class SizeLRUEviction : public CacheEviction {
         void detach(SizeLRUEvictionEntry* node);
         void attach(SizeLRUEvictionEntry* node);
 
+        /*
+         * evicts with purge_size_based() until we are back under capacity
+         */
         void purge_size_based_multimap();
 
         /*
          * FOR LRU ONLY
          * Here we purge based on size.
          * we look at the least recently requested "purge_size_based_limit" files
-         * and pick the one with the largest size
+         * and pick the one with the largest size. Evicts a single entry.
          */
         void purge_size_based();
+        void refill_size_window();
+        void reset_size_window();
+        bool skip_size_based_deletion(const std::string& customer_id);
+        void evict(SizeLRUEvictionEntry* node);
 
         std::string return_customer_id(std::string url);
 };
@@ -6,6 +6,8 @@
 #ifndef STATUS_H__
 #define STATUS_H__
 
+#define NEXT_ACCESS_NEVER ((unsigned long long) -1)
+
 struct item_packet {
     unsigned long ts;
     unsigned long size;
@@ -18,6 +20,8 @@ struct item_packet {
     std::string status_code_full;
     std::string status_code_string;
     int status_code_number;
+    unsigned long long request; // index among processed lines, offline runs only
+    unsigned long long next_access; // request index of the next one for this key, or NEXT_ACCESS_NEVER
 };
 
 struct cache_stat_packet {
@@ -0,0 +1,55 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Hierarchical timer wheel over the simulated timestamp (1 second ticks)
+ *
+ * TIMER_WHEEL_LEVELS levels of TIMER_WHEEL_SLOTS slots each. A timer sits in
+ * the lowest level whose span covers its distance from the clock and moves
+ * down one level each time the level below wraps, so a timer is touched at
+ * most TIMER_WHEEL_LEVELS times before it fires. Timers further out than the
+ * whole wheel are parked in the top level and simply come back due early,
+ * callers are expected to re-check and reschedule.
+ */
+
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+
+#include <vector>
+
+#include "fifo_eviction.h"
+
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS 4
+
+class TimerWheel {
+    private:
+        FIFOEvictionEntry*          slots[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+        unsigned long long          level_count[TIMER_WHEEL_LEVELS];
+        unsigned long long          timer_count;
+        unsigned long               current; // next tick not processed yet
+
+        void insert(FIFOEvictionEntry* node);
+        void unlink(FIFOEvictionEntry* node);
+        void cascade(unsigned int level);
+
+    public:
+        TimerWheel();
+
+        /* (Re)arm the timer of node to fire at tick 'when' */
+        void schedule(FIFOEvictionEntry* node, unsigned long when);
+        /* No-op if node has no timer */
+        void cancel(FIFOEvictionEntry* node);
+
+        /*
+         * Runs the clock up to and including 'now' and appends every timer
+         * that came due to 'due' (they are no longer scheduled)
+         */
+        void advance(unsigned long now, std::vector<FIFOEvictionEntry*>& due);
+
+        unsigned long long size();
+};
+
+#endif /* TIMER_WHEEL_H_ */
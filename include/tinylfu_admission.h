@@ -0,0 +1,96 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * TinyLFU admission
+ *
+ * Every request (hits through record_hit, misses through check) is counted
+ * in a count-min sketch of 4 bit counters, TINYLFU_ROWS rows of `width`
+ * counters, behind a doorkeeper bit filter that absorbs one-hit wonders.
+ * After 10 * width counted requests all counters are halved and the
+ * doorkeeper is cleared, so old popularity fades instead of being dropped at
+ * once like a bloom filter rotation.
+ *
+ * A miss that fits in free space is admitted. Otherwise the eviction policy
+ * is asked which entries the object would displace (peek_victims), and it is
+ * admitted only if its estimated frequency beats their byte weighted mean.
+ * Policies that can't tell fall back to second-hit.
+ *
+ * Memory is about 4 bytes per width: 2 for the sketch, 2 for the doorkeeper.
+ */
+
+#ifndef TINYLFU_ADMISSION_H_
+#define TINYLFU_ADMISSION_H_
+
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cache_policy.h"
+
+#define TINYLFU_ROWS 4
+#define TINYLFU_COUNTER_MAX 15
+#define TINYLFU_SAMPLE_FACTOR 10 // requests per counter before halving
+#define TINYLFU_DOOR_BITS 16 // doorkeeper bits per counter
+#define TINYLFU_MAX_VICTIMS 8
+#define TINYLFU_HASH_SEED 0x1f2e3d4c
+
+class TinyLFUAdmission : public CacheAdmission {
+    private:
+        CacheEviction* eviction; // not owned, the policy we admit into
+        std::vector<std::string> no_bf_cust;
+
+        std::vector<uint64_t> sketch; // 16 counters per word, row after row
+        unsigned long width; // counters per row, power of 2
+        std::vector<uint64_t> door; // doorkeeper bits
+        unsigned long door_mask;
+
+        unsigned long long additions;
+        unsigned long long sample_size;
+
+        std::vector<std::pair<std::string, unsigned long> > victims;
+
+        // Reset every periodic_output
+        unsigned long admitted;
+        unsigned long rejected;
+        unsigned long free_admits; // fit without evicting anything
+        unsigned long resets;
+
+        inline unsigned int counter(unsigned int row, uint64_t i) {
+            uint64_t word = sketch[(row * width + i) >> 4];
+            return (word >> ((i & 15) << 2)) & 0xF;
+        }
+        inline void increment(unsigned int row, uint64_t i) {
+            sketch[(row * width + i) >> 4] += 1ULL << ((i & 15) << 2);
+        }
+        inline uint64_t row_index(uint64_t h1, uint64_t h2, unsigned int row) {
+            return (h1 + row * h2) & (width - 1);
+        }
+
+        void hash(const std::string& key, uint64_t& h1, uint64_t& h2);
+        bool door_contains(uint64_t h1, uint64_t h2);
+        void door_put(uint64_t h1, uint64_t h2);
+        void reset();
+
+    public:
+        TinyLFUAdmission(CacheEviction* eviction, unsigned long width,
+                         std::vector<std::string> no_bf_cust);
+        ~TinyLFUAdmission();
+
+        /* Counts one request for key */
+        void record(const std::string& key);
+        /* Estimated recent requests for key, doorkeeper included */
+        unsigned int estimate(const std::string& key);
+
+        bool check(std::string key, unsigned long data, unsigned long long size,
+                   unsigned long ts, std::string customer_id_str);
+        void record_hit(const std::string& key, unsigned long long size,
+                        unsigned long ts, const std::string& customer_id_str);
+        bool check_customer_in_list(std::string custid) const;
+
+        // Reporting
+        void periodic_output(unsigned long ts, std::ostringstream& outlogfile);
+};
+
+#endif /* TINYLFU_ADMISSION_H_ */
@@ -0,0 +1,432 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * ARC and CAR: recency/frequency split tuned by ghost hits
+ *
+ */
+
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "arc_eviction.h"
+
+using namespace std;
+
+void ArcGhostList::push(uint64_t fingerprint, unsigned long data) {
+    take(fingerprint); // a fingerprint collision, keep the newest
+    ArcGhost g;
+    g.fingerprint = fingerprint;
+    g.seq = ++seq;
+    order.push_back(g);
+    Info info;
+    info.seq = g.seq;
+    info.data = data;
+    index[fingerprint] = info;
+    bytes += data;
+
+    // Copies left behind by take() only go in pop_oldest(), which may not run
+    if (order.size() > 2 * index.size() + ARC_GHOST_SLACK) {
+        compact();
+    }
+}
+
+/* Drops the copies left behind by take(), keeping the order */
+void ArcGhostList::compact() {
+    for (size_t n = order.size(); n > 0; n--) {
+        ArcGhost g = order.pop_front();
+        unordered_map<uint64_t, Info>::iterator it = index.find(g.fingerprint);
+        if (it != index.end() && it->second.seq == g.seq) {
+            order.push_back(g);
+        }
+    }
+}
+
+bool ArcGhostList::take(uint64_t fingerprint) {
+    unordered_map<uint64_t, Info>::iterator it = index.find(fingerprint);
+    if (it == index.end()) {
+        return false;
+    }
+    bytes -= it->second.data;
+    index.erase(it);
+    return true;
+}
+
+/* Copies left behind by take() are skipped on the way */
+bool ArcGhostList::pop_oldest() {
+    while (!order.empty()) {
+        ArcGhost g = order.pop_front();
+        unordered_map<uint64_t, Info>::iterator it = index.find(g.fingerprint);
+        if (it != index.end() && it->second.seq == g.seq) {
+            bytes -= it->second.data;
+            index.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**********************************************************/
+
+AdaptiveEviction::AdaptiveEviction(unsigned long long size, string id, const EmConfItems * sci) {
+    this->sci = sci;
+
+    total_capacity = size;
+    cache_id = id;
+    current_size = 0;
+    p = 0;
+
+    t1_bytes = 0;
+    t2_bytes = 0;
+    t1_items = 0;
+    t2_items = 0;
+
+    t1_hits = 0;
+    t2_hits = 0;
+    b1_hits = 0;
+    b2_hits = 0;
+    evicted = 0;
+}
+
+AdaptiveEviction::~AdaptiveEviction()
+{
+    for (unordered_map<string, ArcEvictionEntry*>::iterator it = _mapping.begin(); it != _mapping.end(); ++it) {
+        delete it->second;
+    }
+}
+
+void AdaptiveEviction::hourly_purging(unsigned long timestamp) {
+    while (current_size > total_capacity * .80) {
+        purge_regular();
+    }
+}
+
+int AdaptiveEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    return _mapping.find(key) != _mapping.end();
+}
+
+ArcEvictionEntry* AdaptiveEviction::new_entry(const string& key, unsigned long data,
+                                              unsigned long timestamp, const string& customer_id) {
+    ArcEvictionEntry* node = new ArcEvictionEntry;
+    node->key = key;
+    node->customer_id = customer_id;
+    node->data = data;
+    node->timestamp = timestamp;
+    node->count = 1;
+    node->in_t2 = false;
+    node->referenced = false;
+    node->prev = NULL;
+    node->next = NULL;
+    return node;
+}
+
+bool AdaptiveEviction::adapt(const string& key, unsigned long data, bool& from_b2) {
+    uint64_t fp = fingerprint(key);
+    double b1_bytes = b1.get_bytes();
+    double b2_bytes = b2.get_bytes();
+    from_b2 = false;
+
+    if (b1.take(fp)) {
+        // T1 was too small
+        double ratio = b2_bytes > b1_bytes ? b2_bytes / b1_bytes : 1;
+        p += ratio * data;
+        if (p > total_capacity) {
+            p = total_capacity;
+        }
+        b1_hits++;
+        return true;
+    }
+    if (b2.take(fp)) {
+        double ratio = b1_bytes > b2_bytes ? b1_bytes / b2_bytes : 1;
+        p -= ratio * data;
+        if (p < 0) {
+            p = 0;
+        }
+        b2_hits++;
+        from_b2 = true;
+        return true;
+    }
+    return false;
+}
+
+void AdaptiveEviction::evict(ArcEvictionEntry* node) {
+    if (node->in_t2) {
+        t2_bytes -= node->data;
+        t2_items--;
+        b2.push(fingerprint(node->key), node->data);
+    }
+    else {
+        t1_bytes -= node->data;
+        t1_items--;
+        b1.push(fingerprint(node->key), node->data);
+    }
+    evicted++;
+    current_size -= node->data;
+    _mapping.erase(node->key);
+    delete node;
+}
+
+void AdaptiveEviction::trim_ghosts() {
+    while (b1.get_bytes() + t1_bytes > total_capacity && b1.pop_oldest()) {
+    }
+    while (current_size + b1.get_bytes() + b2.get_bytes() > 2 * total_capacity && b2.pop_oldest()) {
+    }
+    // No more fingerprints than cached objects
+    while (b1.size() + b2.size() > t1_items + t2_items) {
+        if (b1.size() >= b2.size()) {
+            b1.pop_oldest();
+        } else {
+            b2.pop_oldest();
+        }
+    }
+}
+
+unsigned long long AdaptiveEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long AdaptiveEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void AdaptiveEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << (unsigned long long) p << " "
+        << t1_bytes << " "
+        << t2_bytes << " "
+        << b1.get_bytes() << " "
+        << b2.get_bytes() << " "
+        << t1_items << " "
+        << t2_items << " "
+        << b1.size() << " "
+        << b2.size() << " "
+        << t1_hits << " "
+        << t2_hits << " "
+        << b1_hits << " "
+        << b2_hits << " "
+        << evicted << " ";
+
+    t1_hits = 0;
+    t2_hits = 0;
+    b1_hits = 0;
+    b2_hits = 0;
+    evicted = 0;
+}
+
+/**********************************************************/
+
+ArcEviction::ArcEviction(unsigned long long size, string id, const EmConfItems * sci)
+    : AdaptiveEviction(size, id, sci) {
+    name = "arc";
+
+    t1_head = new ArcEvictionEntry;
+    t1_tail = new ArcEvictionEntry;
+    t2_head = new ArcEvictionEntry;
+    t2_tail = new ArcEvictionEntry;
+    t1_head->prev = NULL;
+    t1_head->next = t1_tail;
+    t1_tail->prev = t1_head;
+    t1_tail->next = NULL;
+    t2_head->prev = NULL;
+    t2_head->next = t2_tail;
+    t2_tail->prev = t2_head;
+    t2_tail->next = NULL;
+
+    replace_from_b2 = false;
+}
+
+ArcEviction::~ArcEviction()
+{
+    delete t1_head;
+    delete t1_tail;
+    delete t2_head;
+    delete t2_tail;
+}
+
+void ArcEviction::detach(ArcEvictionEntry* node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+}
+
+void ArcEviction::attach(ArcEvictionEntry* node, ArcEvictionEntry* head) {
+    node->next = head->next;
+    node->prev = head;
+    node->next->prev = node;
+    head->next = node;
+}
+
+unsigned long long ArcEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    bool from_b2;
+    bool to_t2 = adapt(key, data, from_b2);
+
+    // Make room first, the choice of list depends on the ghost hit
+    replace_from_b2 = from_b2;
+    while (current_size + data > total_capacity && purge_regular()) {
+    }
+    replace_from_b2 = false;
+
+    ArcEvictionEntry* node = new_entry(key, data, timestamp, customer_id);
+    node->in_t2 = to_t2;
+    if (to_t2) {
+        attach(node, t2_head);
+        t2_bytes += data;
+        t2_items++;
+    }
+    else {
+        attach(node, t1_head);
+        t1_bytes += data;
+        t1_items++;
+    }
+    _mapping[key] = node;
+    current_size += data;
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity && purge_regular()) {
+    }
+    trim_ghosts();
+    return current_size;
+}
+
+unsigned long ArcEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, ArcEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    ArcEvictionEntry* node = it->second;
+    if (node->in_t2) {
+        t2_hits++;
+    }
+    else {
+        t1_hits++;
+        node->in_t2 = true;
+        t1_bytes -= node->data;
+        t1_items--;
+        t2_bytes += node->data;
+        t2_items++;
+    }
+    detach(node);
+    attach(node, t2_head);
+
+    node->count++;
+    node->timestamp = ts;
+    return node->data;
+}
+
+bool ArcEviction::purge_regular() {
+    ArcEvictionEntry* node;
+    if (t1_items > 0 && (t1_bytes > p || (replace_from_b2 && t1_bytes >= p) || t2_items == 0)) {
+        node = t1_tail->prev;
+    }
+    else if (t2_items > 0) {
+        node = t2_tail->prev;
+    }
+    else {
+        return false;
+    }
+
+    detach(node);
+    evict(node);
+    return true;
+}
+
+/**********************************************************/
+
+CarEviction::CarEviction(unsigned long long size, string id, const EmConfItems * sci)
+    : AdaptiveEviction(size, id, sci) {
+    name = "car";
+}
+
+unsigned long long CarEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    bool from_b2;
+    bool to_t2 = adapt(key, data, from_b2);
+
+    while (current_size + data > total_capacity && purge_regular()) {
+    }
+
+    ArcEvictionEntry* node = new_entry(key, data, timestamp, customer_id);
+    node->in_t2 = to_t2;
+    if (to_t2) {
+        t2.push_back(node);
+        t2_bytes += data;
+        t2_items++;
+    }
+    else {
+        t1.push_back(node);
+        t1_bytes += data;
+        t1_items++;
+    }
+    _mapping[key] = node;
+    current_size += data;
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity && purge_regular()) {
+    }
+    trim_ghosts();
+    return current_size;
+}
+
+unsigned long CarEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, ArcEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    // Nothing moves on a hit
+    ArcEvictionEntry* node = it->second;
+    node->referenced = true;
+    if (node->in_t2) {
+        t2_hits++;
+    } else {
+        t1_hits++;
+    }
+
+    node->count++;
+    node->timestamp = ts;
+    return node->data;
+}
+
+/* Each referenced entry passed loses its bit, so this ends */
+bool CarEviction::purge_regular() {
+    while (true) {
+        if (!t1.empty() && (t1_bytes >= (p > 1 ? p : 1) || t2.empty())) {
+            ArcEvictionEntry* node = t1.pop_front();
+            if (!node->referenced) {
+                evict(node);
+                return true;
+            }
+            // Seen twice, on to T2
+            node->referenced = false;
+            node->in_t2 = true;
+            t1_bytes -= node->data;
+            t1_items--;
+            t2_bytes += node->data;
+            t2_items++;
+            t2.push_back(node);
+        }
+        else if (!t2.empty()) {
+            ArcEvictionEntry* node = t2.pop_front();
+            if (!node->referenced) {
+                evict(node);
+                return true;
+            }
+            node->referenced = false;
+            t2.push_back(node);
+        }
+        else {
+            return false;
+        }
+    }
+}
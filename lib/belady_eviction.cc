@@ -0,0 +1,238 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Belady: offline eviction by next access
+ *
+ */
+
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "status.h"
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "belady_eviction.h"
+
+using namespace std;
+
+OfflineEviction::OfflineEviction(unsigned long long size, string id, const EmConfItems * sci) {
+    this->sci = sci;
+
+    total_capacity = size;
+    cache_id = id;
+    current_size = 0;
+    now = 0;
+    upcoming = NEXT_ACCESS_NEVER;
+    incoming = NULL;
+
+    evicted = 0;
+    evicted_bytes = 0;
+    evicted_never = 0;
+    bypassed = 0;
+}
+
+OfflineEviction::~OfflineEviction()
+{
+    for (unordered_map<string, BeladyEvictionEntry*>::iterator it = _mapping.begin(); it != _mapping.end(); ++it) {
+        delete it->second;
+    }
+}
+
+void OfflineEviction::set_next_access(unsigned long long request, unsigned long long next_access) {
+    now = request;
+    upcoming = next_access;
+}
+
+void OfflineEviction::hourly_purging(unsigned long timestamp) {
+    while (current_size > total_capacity * .80) {
+        purge_regular();
+    }
+}
+
+int OfflineEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    return _mapping.find(key) != _mapping.end();
+}
+
+BeladyEvictionEntry* OfflineEviction::new_entry(const string& key, unsigned long data,
+                                                unsigned long timestamp, const string& customer_id) {
+    BeladyEvictionEntry* node = new BeladyEvictionEntry;
+    node->key = key;
+    node->customer_id = customer_id;
+    node->data = data;
+    node->timestamp = timestamp;
+    node->count = 1;
+    node->next_access = upcoming;
+    node->heap_index = INDEXED_HEAP_NONE;
+    node->slot = 0;
+    return node;
+}
+
+void OfflineEviction::evict(BeladyEvictionEntry* node) {
+    evicted++;
+    evicted_bytes += node->data;
+    if (node->next_access == NEXT_ACCESS_NEVER) {
+        evicted_never++;
+    }
+    if (node == incoming) {
+        bypassed++;
+        incoming = NULL;
+    }
+    current_size -= node->data;
+    _mapping.erase(node->key);
+    delete node;
+}
+
+unsigned long long OfflineEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long OfflineEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void OfflineEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << _mapping.size() << " "
+        << evicted << " "
+        << evicted_bytes << " "
+        << evicted_never << " "
+        << bypassed << " ";
+
+    evicted = 0;
+    evicted_bytes = 0;
+    evicted_never = 0;
+    bypassed = 0;
+}
+
+/**********************************************************/
+
+BeladyEviction::BeladyEviction(unsigned long long size, string id, const EmConfItems * sci)
+    : OfflineEviction(size, id, sci) {
+    name = "belady";
+}
+
+unsigned long long BeladyEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    // In first, it may well be the one to go
+    BeladyEvictionEntry* node = new_entry(key, data, timestamp, customer_id);
+    _mapping[key] = node;
+    heap.push(node);
+    current_size += data;
+
+    incoming = node;
+    while (current_size > total_capacity && purge_regular()) {
+    }
+    incoming = NULL;
+    return current_size;
+}
+
+unsigned long BeladyEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, BeladyEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    BeladyEvictionEntry* node = it->second;
+    node->next_access = upcoming;
+    heap.update(node);
+
+    node->count++;
+    node->timestamp = ts;
+    return node->data;
+}
+
+bool BeladyEviction::purge_regular() {
+    if (heap.empty()) {
+        return false;
+    }
+    evict(heap.pop());
+    return true;
+}
+
+/**********************************************************/
+
+BeladySizeEviction::BeladySizeEviction(unsigned long long size, string id, const EmConfItems * sci)
+    : OfflineEviction(size, id, sci) {
+    name = "belady_size";
+}
+
+void BeladySizeEviction::place(BeladyEvictionEntry* node) {
+    vector<BeladyEvictionEntry*>& to = node->next_access == NEXT_ACCESS_NEVER ? never_again : entries;
+    node->slot = to.size();
+    to.push_back(node);
+}
+
+void BeladySizeEviction::unplace(BeladyEvictionEntry* node) {
+    vector<BeladyEvictionEntry*>& from = node->next_access == NEXT_ACCESS_NEVER ? never_again : entries;
+    assert(node->slot < from.size() && from[node->slot] == node);
+    from[node->slot] = from.back();
+    from[node->slot]->slot = node->slot;
+    from.pop_back();
+}
+
+unsigned long long BeladySizeEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    BeladyEvictionEntry* node = new_entry(key, data, timestamp, customer_id);
+    _mapping[key] = node;
+    place(node);
+    current_size += data;
+
+    incoming = node;
+    while (current_size > total_capacity && purge_regular()) {
+    }
+    incoming = NULL;
+    return current_size;
+}
+
+unsigned long BeladySizeEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, BeladyEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    BeladyEvictionEntry* node = it->second;
+    unplace(node);
+    node->next_access = upcoming;
+    place(node);
+
+    node->count++;
+    node->timestamp = ts;
+    return node->data;
+}
+
+bool BeladySizeEviction::purge_regular() {
+    BeladyEvictionEntry* victim;
+    if (!never_again.empty()) {
+        victim = never_again.back();
+    }
+    else if (!entries.empty()) {
+        victim = NULL;
+        double worst = -1;
+        unsigned int samples = entries.size() < BELADY_SIZE_SAMPLES ? entries.size() : BELADY_SIZE_SAMPLES;
+        for (unsigned int i = 0; i < samples; i++) {
+            BeladyEvictionEntry* node = entries[rng.below(entries.size())];
+            double rank = (double) (node->next_access - now) * node->data;
+            if (rank > worst) {
+                worst = rank;
+                victim = node;
+            }
+        }
+    }
+    else {
+        return false;
+    }
+
+    unplace(victim);
+    evict(victim);
+    return true;
+}
@@ -73,11 +73,21 @@ void Cache::set_admission(CacheAdmission* new_ad) {
 void Cache::set_eviction(CacheEviction* new_ev) {
     eviction = new_ev;
 }
+void Cache::set_seed(unsigned long long seed) {
+    if (admission) {
+        admission->set_seed(seed);
+    }
+    if (eviction) {
+        eviction->set_seed(~seed);
+    }
+}
 
 bool Cache::process(item_packet* ip_inst){
     bool penalize_url = false;
     string cache_key = ip_inst->city64_str;
 
+    // Only offline policies look at this
+    eviction->set_next_access(ip_inst->request, ip_inst->next_access);
 
     // Actually Check the cache
     if (!check(cache_key, ip_inst->size, ip_inst->ts, penalize_url,
@@ -304,6 +314,7 @@ bool Cache::check(string url, unsigned long size, unsigned long ts,  bool penali
     if(eviction->check(url, ts)) { // found
         //kc->add(url,size, ts, bytes_out, customer_id_str);
         eviction->get(url, ts, bytes_out, customer_id_str);
+        admission->record_hit(url, size, ts, customer_id_str);
         number_of_reads += (size / number_of_bytes_per_read) + 1;
         return true;
     }
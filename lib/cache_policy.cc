@@ -3,11 +3,21 @@
 // See LICENSE file for terms.
 
 # include <string>
+# include <utility>
+# include <vector>
 # include "cache_policy.h"
 
 CacheAdmission::~CacheAdmission() {
 }
 
+void CacheAdmission::set_seed(uint64_t seed) {
+    rng.seed(seed);
+}
+
+void CacheAdmission::record_hit(const std::string& key, unsigned long long size,
+                                unsigned long ts, const std::string& customer_id_str) {
+}
+
 CacheEviction::~CacheEviction() {
 }
 
@@ -15,3 +25,15 @@ CacheEviction::~CacheEviction() {
 void CacheEviction::set_total_capacity_by_value(unsigned long long size) {
     total_capacity = size;
 }
+
+void CacheEviction::set_seed(uint64_t seed) {
+    rng.seed(seed);
+}
+
+bool CacheEviction::peek_victims(unsigned long long incoming, size_t max_victims,
+                                 std::vector<std::pair<std::string, unsigned long> >& victims) {
+    return false;
+}
+
+void CacheEviction::set_next_access(unsigned long long request, unsigned long long next_access) {
+}
@@ -0,0 +1,226 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * CLOCK and SIEVE: a hand sweeping a slot array
+ *
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "clock_eviction.h"
+
+using namespace std;
+
+ClockEviction::ClockEviction(unsigned long long size, string id, const EmConfItems * sci,
+                             unsigned int bits, bool reuse_holes)
+    : counters(bits) {
+    this->sci = sci;
+    this->reuse_holes = reuse_holes;
+
+    total_capacity = size;
+    cache_id = id;
+    current_size = 0;
+    hand = 0;
+    holes = 0;
+
+    evicted = 0;
+    evicted_bytes = 0;
+    hand_steps = 0;
+    compactions = 0;
+}
+
+/* Before PackedCounters gets them, which divides by them */
+static unsigned int checked_clock_bits(const EmConfItems * sci) {
+    if (sci->clock_bits < 1 || sci->clock_bits > CLOCK_MAX_BITS) {
+        cerr << "\nclock_bits must be 1 to " << CLOCK_MAX_BITS << ", got " << sci->clock_bits << ". Exiting.\n";
+        exit(1);
+    }
+    return sci->clock_bits;
+}
+
+ClockEviction::ClockEviction(unsigned long long size, string id, const EmConfItems * sci)
+    : ClockEviction(size, id, sci, checked_clock_bits(sci), true) {
+    name = "clock";
+}
+
+ClockEviction::~ClockEviction()
+{
+    for (size_t i = 0; i < slots.size(); i++) {
+        delete slots[i];
+    }
+}
+
+void ClockEviction::hourly_purging(unsigned long timestamp) {
+    while (current_size > total_capacity * .80) {
+        purge_regular();
+    }
+}
+
+unsigned long long ClockEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    ClockEvictionEntry* node = new ClockEvictionEntry;
+    node->key = key;
+    node->customer_id = customer_id;
+    node->data = data;
+    node->timestamp = timestamp;
+    node->count = 1;
+
+    if (reuse_holes && !free_slots.empty()) {
+        node->slot = free_slots.back();
+        free_slots.pop_back();
+        holes--;
+    }
+    else {
+        node->slot = slots.size();
+        slots.push_back(NULL);
+        counters.resize(slots.size());
+    }
+    slots[node->slot] = node;
+    counters.set(node->slot, 0);
+
+    _mapping[key] = node;
+    current_size += data;
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity) {
+        purge_regular();
+    }
+    return current_size;
+}
+
+unsigned long ClockEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, ClockEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    ClockEvictionEntry* node = it->second;
+    unsigned int c = counters.get(node->slot);
+    if (c < counters.max_value()) {
+        counters.set(node->slot, c + 1);
+    }
+    node->count++;
+    node->timestamp = ts;
+    return node->data;
+}
+
+int ClockEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    return _mapping.find(key) != _mapping.end();
+}
+
+bool ClockEviction::purge_regular() {
+    if (_mapping.empty()) {
+        return false;
+    }
+
+    // Every full turn takes one off each counter, so this ends
+    while (true) {
+        if (hand >= slots.size()) {
+            hand = 0;
+        }
+        hand_steps++;
+        ClockEvictionEntry* node = slots[hand];
+        if (node == NULL) {
+            hand++;
+            continue;
+        }
+        unsigned int c = counters.get(hand);
+        if (c > 0) {
+            counters.set(hand, c - 1);
+            hand++;
+            continue;
+        }
+
+        slots[hand] = NULL;
+        if (reuse_holes) {
+            free_slots.push_back(hand);
+        }
+        holes++;
+        hand++;
+
+        evicted++;
+        evicted_bytes += node->data;
+        current_size -= node->data;
+        _mapping.erase(node->key);
+        delete node;
+        break;
+    }
+
+    if (slots.size() >= CLOCK_MIN_COMPACT && holes * 2 > slots.size()) {
+        compact();
+    }
+    return true;
+}
+
+/* Squeeze out the holes, keeping the slot order and the hand's place in it */
+void ClockEviction::compact() {
+    size_t live = 0;
+    size_t new_hand = 0;
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (i == hand) {
+            new_hand = live;
+        }
+        ClockEvictionEntry* node = slots[i];
+        if (node == NULL) {
+            continue;
+        }
+        counters.set(live, counters.get(i));
+        slots[live] = node;
+        node->slot = live;
+        live++;
+    }
+    if (hand >= slots.size()) {
+        new_hand = live;
+    }
+
+    slots.resize(live);
+    counters.resize(live);
+    free_slots.clear();
+    holes = 0;
+    hand = new_hand;
+    compactions++;
+}
+
+unsigned long long ClockEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long ClockEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void ClockEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << _mapping.size() << " "
+        << slots.size() << " "
+        << counters.max_value() << " "
+        << evicted << " "
+        << evicted_bytes << " "
+        << hand_steps << " "
+        << compactions << " ";
+
+    evicted = 0;
+    evicted_bytes = 0;
+    hand_steps = 0;
+    compactions = 0;
+}
+
+/**********************************************************/
+
+SieveEviction::SieveEviction(unsigned long long size, string id, const EmConfItems * sci)
+    : ClockEviction(size, id, sci, 1, false) {
+    name = "sieve";
+}
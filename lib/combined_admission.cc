@@ -0,0 +1,153 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+/*
+ * Admission combinators
+ *
+ */
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <unordered_set>
+
+#include "cache_policy.h"
+#include "combined_admission.h"
+
+using namespace std;
+
+AdmissionCombinator::AdmissionCombinator() {
+    admitted = 0;
+    rejected = 0;
+}
+
+AdmissionCombinator::~AdmissionCombinator() {
+    for (size_t i = 0; i < branches.size(); i++) {
+        delete branches[i];
+    }
+}
+
+void AdmissionCombinator::add_branch(CacheAdmission* branch) {
+    branches.push_back(branch);
+    branch_accepted.push_back(0);
+    branch_rejected.push_back(0);
+}
+
+bool AdmissionCombinator::ask(size_t i, const string& key, unsigned long data, unsigned long long size,
+                              unsigned long ts, const string& customer_id_str) {
+    if (branches[i]->check(key, data, size, ts, customer_id_str)) {
+        branch_accepted[i]++;
+        return true;
+    }
+    branch_rejected[i]++;
+    return false;
+}
+
+void AdmissionCombinator::set_seed(uint64_t seed) {
+    rng.seed(seed);
+    for (size_t i = 0; i < branches.size(); i++) {
+        branches[i]->set_seed(splitmix64(seed));
+    }
+}
+
+void AdmissionCombinator::record_hit(const string& key, unsigned long long size,
+                                     unsigned long ts, const string& customer_id_str) {
+    for (size_t i = 0; i < branches.size(); i++) {
+        branches[i]->record_hit(key, size, ts, customer_id_str);
+    }
+}
+
+void AdmissionCombinator::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << admitted << " " << rejected << " ";
+    for (size_t i = 0; i < branches.size(); i++) {
+        outlogfile << branch_accepted[i] << " " << branch_rejected[i] << " ";
+        branch_accepted[i] = 0;
+        branch_rejected[i] = 0;
+    }
+    admitted = 0;
+    rejected = 0;
+
+    for (size_t i = 0; i < branches.size(); i++) {
+        branches[i]->periodic_output(ts, outlogfile);
+    }
+}
+
+/**********************************************************/
+
+AndAdmission::AndAdmission(CacheAdmission* a, CacheAdmission* b) {
+    name = "and";
+    add_branch(a);
+    add_branch(b);
+}
+
+bool AndAdmission::check(string key, unsigned long data, unsigned long long size,
+                         unsigned long ts, string customer_id_str) {
+    return decide(ask(0, key, data, size, ts, customer_id_str)
+                  && ask(1, key, data, size, ts, customer_id_str));
+}
+
+/**********************************************************/
+
+OrAdmission::OrAdmission(CacheAdmission* a, CacheAdmission* b) {
+    name = "or";
+    add_branch(a);
+    add_branch(b);
+}
+
+bool OrAdmission::check(string key, unsigned long data, unsigned long long size,
+                        unsigned long ts, string customer_id_str) {
+    return decide(ask(0, key, data, size, ts, customer_id_str)
+                  || ask(1, key, data, size, ts, customer_id_str));
+}
+
+/**********************************************************/
+
+NotAdmission::NotAdmission(CacheAdmission* a) {
+    name = "not";
+    add_branch(a);
+}
+
+bool NotAdmission::check(string key, unsigned long data, unsigned long long size,
+                         unsigned long ts, string customer_id_str) {
+    return decide(!ask(0, key, data, size, ts, customer_id_str));
+}
+
+/**********************************************************/
+
+SizeGatedAdmission::SizeGatedAdmission(unsigned long long min_size, unsigned long long max_size,
+                                       CacheAdmission* inner, bool outside) {
+    name = "size_gate";
+    this->min_size = min_size;
+    this->max_size = max_size;
+    this->outside = outside;
+    add_branch(inner);
+}
+
+bool SizeGatedAdmission::check(string key, unsigned long data, unsigned long long size,
+                               unsigned long ts, string customer_id_str) {
+    if (size < min_size || (max_size && size >= max_size)) {
+        return decide(outside);
+    }
+    return decide(ask(0, key, data, size, ts, customer_id_str));
+}
+
+/**********************************************************/
+
+CustomerGatedAdmission::CustomerGatedAdmission(const vector<string>& customers,
+                                               CacheAdmission* inner, bool outside) {
+    name = "customer_gate";
+    this->customers.insert(customers.begin(), customers.end());
+    this->outside = outside;
+    add_branch(inner);
+}
+
+bool CustomerGatedAdmission::check(string key, unsigned long data, unsigned long long size,
+                                   unsigned long ts, string customer_id_str) {
+    if (customers.find(customer_id_str) == customers.end()) {
+        return decide(outside);
+    }
+    return decide(ask(0, key, data, size, ts, customer_id_str));
+}
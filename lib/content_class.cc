@@ -0,0 +1,54 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Content class by extension
+ *
+ */
+
+#include <strings.h>
+#include <string>
+
+#include "content_class.h"
+
+using namespace std;
+
+static const char* content_video[] = { "ts", "m4s", "mp4", "m4v", "m4a", "aac", "mp3", "webm", "mkv", "mov", "flv", NULL };
+static const char* content_manifest[] = { "m3u8", "mpd", "ism", "f4m", NULL };
+static const char* content_image[] = { "jpg", "jpeg", "png", "gif", "webp", "svg", "ico", "bmp", NULL };
+static const char* content_web[] = { "html", "htm", "js", "css", "json", "xml", "txt", NULL };
+static const char* content_download[] = { "zip", "gz", "tar", "exe", "bin", "dmg", "pkg", "apk", "iso", "pdf", NULL };
+
+static bool in_list(const char** list, const string& extension) {
+    for (; *list != NULL; list++) {
+        if (strcasecmp(*list, extension.c_str()) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ContentClass content_class(const string& url) {
+    size_t dot = url.rfind('.');
+    size_t slash = url.rfind('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        return CONTENT_OTHER;
+    }
+    string extension = url.substr(dot + 1);
+    if (in_list(content_video, extension)) {
+        return CONTENT_VIDEO;
+    }
+    if (in_list(content_manifest, extension)) {
+        return CONTENT_MANIFEST;
+    }
+    if (in_list(content_image, extension)) {
+        return CONTENT_IMAGE;
+    }
+    if (in_list(content_web, extension)) {
+        return CONTENT_WEB;
+    }
+    if (in_list(content_download, extension)) {
+        return CONTENT_DOWNLOAD;
+    }
+    return CONTENT_OTHER;
+}
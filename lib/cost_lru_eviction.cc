@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <sstream>
 #include <fstream>
+#include <string.h>
 
 #include "em_structs.h"
 #include "cache_policy.h"
@@ -65,6 +66,8 @@ CostLRUEviction::CostLRUEviction(unsigned long long size, string id, const
     current_ingress_item_timestamp = 0;
 
     purge_size_based_limit = sci->LRU_list_size;
+    window_front = tail;
+    window_span = 0;
 
     cache_item_count = 0;
     max_cache_item_count = 0;
@@ -90,10 +93,33 @@ CostLRUEviction::CostLRUEviction(unsigned long long size, string id, const
 
     hour_count = 0;
 
+    if (sci->customer_fair_eviction) {
+        customer_recency.enable_fairness();
+    }
+
+    class_head = new CostLRUEvictionEntry*[COST_LRU_SCORE_CLASSES];
+    class_tail = new CostLRUEvictionEntry*[COST_LRU_SCORE_CLASSES];
+    for (int i = 0; i < COST_LRU_SCORE_CLASSES; i++) {
+        class_head[i] = new CostLRUEvictionEntry;
+        class_tail[i] = new CostLRUEvictionEntry;
+        class_head[i]->class_prev = NULL;
+        class_head[i]->class_next = class_tail[i];
+        class_tail[i]->class_next = NULL;
+        class_tail[i]->class_prev = class_head[i];
+    }
+    memset(class_bitmap, 0, sizeof(class_bitmap));
+
 }
 
 CostLRUEviction::~CostLRUEviction()
 {
+    for (int i = 0; i < COST_LRU_SCORE_CLASSES; i++) {
+        delete class_head[i];
+        delete class_tail[i];
+    }
+    delete [] class_head;
+    delete [] class_tail;
+
     delete head;
     delete tail;
 }
@@ -226,24 +252,10 @@ void CostLRUEviction::print_oldest_file_age_for_monitored_customers(unsigned lon
     }
     cout << endl;
     for(vector<string>::const_iterator i = sci->monitor_customers_list.begin(); i != sci->monitor_customers_list.end(); ++i) {
-        CostLRUEvictionEntry* currentNode = tail;
-        bool item_found = false;
-        for (currentNode = currentNode->prev; currentNode != head; currentNode = currentNode->prev) {
-            if(currentNode->customer_id.compare(*i) == 0) {
-                item_found = true;
-                cout << "print_oldest_file_age_days "
-                    << *i << " "
-                    << (float) (currentTimeStamp - currentNode->timestamp)/60/60/24 // days
-                    << "\n";
-                break;
-            }
-        }
-        if(!item_found) {
-            cout << "print_oldest_file_age_days "
-                << *i << " "
-                << 0
-                << "\n";
-        }
+        cout << "print_oldest_file_age_days "
+            << *i << " "
+            << customer_recency.oldest_age_days(*i, currentTimeStamp) // days
+            << "\n";
     }
     cout << endl;
 }
@@ -295,8 +307,17 @@ unsigned long long CostLRUEviction::put(string key, unsigned long data, unsigned
             max_cache_item_count = cache_item_count;
         }
 
+        customer_recency.record_request(node, bytes_out, false);
+        if (customer_recency.update_budgets(timestamp, total_capacity, sci->floor_customer_loss)) {
+            // Protection is decided as entries join the window
+            reset_size_window();
+        }
+
         // Bring it back under size if needed
-        if(current_size > total_capacity) {
+        if (sci->customer_fair_eviction) {
+            purge_customer_based();
+        }
+        else if(current_size > total_capacity) {
             decide_items_based_on_score();
         }
 
@@ -350,6 +371,7 @@ unsigned long CostLRUEviction::get(string key, unsigned long ts, unsigned long b
         detach(node);
         attach(node);
         node->count = node->count + 1;
+        customer_recency.record_request(node, bytes_out, true);
 
         avg_oldest_requested_file_vector.push_back(node->timestamp);
 
@@ -508,38 +530,74 @@ void CostLRUEviction::set_total_capacity_by_value(unsigned long long size) {
     total_capacity = size;
 }
 
+/*
+ * Evict the highest scoring items until we are back under capacity. Only the
+ * LRU tail of each score class is a candidate, so each eviction scores at most
+ * one entry per non-empty class against the current size mean/variance and
+ * the current age range.
+ */
 void CostLRUEviction::decide_items_based_on_score() {
-    compute_scores();
     unsigned long long _total_items_purged = 0;
-    std::vector<std::pair<double, string> > score_vector; // pair = score, hash
-    for (std::unordered_map<string, s_item_attr>::iterator it = m_item_unordered_map.begin(); it != m_item_unordered_map.end(); ++it ) {
-        score_vector.push_back(std::make_pair(it->second.score, it->first));
-    }
-    std::sort(score_vector.begin(), score_vector.end()); // ascending order
-
-    for(std::vector<std::pair<double, string> >::reverse_iterator it = score_vector.rbegin(); it != score_vector.rend(); ++it) {
-        if(current_size > total_capacity) {
-            CostLRUEvictionEntry* node = _mapping[it->second];
-            if (sci->debug) {
-                cout << "\ndecide_items_based_on_score "
-                    << head->next->timestamp << " "
-                    << m_item_unordered_map[it->second].score << " "
-                    << node->timestamp << " " << node->data << " " << it->second << "\n";
-            }
-            detach(node);
-            _mapping.erase(node->key);
-            delete node;
-            --cache_item_count;
-            _total_items_purged++;
 
-            m_item_unordered_map.erase(it->second);
+    while (current_size > total_capacity) {
+        CostLRUEvictionEntry* node = pick_score_victim();
+        if (node == NULL) {
+            break;
         }
+        if (sci->debug) {
+            cout << "\ndecide_items_based_on_score "
+                << head->next->timestamp << " "
+                << compute_score(node) << " "
+                << node->timestamp << " " << node->data << " " << node->key << "\n";
+        }
+        detach(node);
+        _mapping.erase(node->key);
+        m_item_unordered_map.erase(node->key);
+        delete node;
+        --cache_item_count;
+        _total_items_purged++;
     }
     //cout << endl << "total_items_purged " << _total_items_purged << endl;
 }
 
+CostLRUEvictionEntry* CostLRUEviction::pick_score_victim() {
+    CostLRUEvictionEntry* victim = NULL;
+    double victim_score = 0;
+
+    for (int w = 0; w < COST_LRU_SCORE_CLASSES / 64; w++) {
+        uint64_t bits = class_bitmap[w];
+        while (bits) {
+            int c = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            CostLRUEvictionEntry* candidate = class_tail[c]->class_prev;
+            double score = compute_score(candidate);
+            if (victim == NULL || score > victim_score) {
+                victim = candidate;
+                victim_score = score;
+            }
+        }
+    }
+    return victim;
+}
 
+unsigned short CostLRUEviction::get_score_class(CostLRUEvictionEntry* node) {
+    int size_class = 0;
+    if (node->data > 1) {
+        size_class = (int) (log2(node->data) * COST_LRU_CLASSES_PER_OCTAVE);
+    }
+    if (size_class >= COST_LRU_SIZE_CLASSES) {
+        size_class = COST_LRU_SIZE_CLASSES - 1;
+    }
 
+    // Only formula 2 treats bypassed customers differently
+    int bypass = 0;
+    if (2 == eviction_formula
+        && sci->check_customer_in_list(node->customer_id, sci->no_bf_cust)) {
+        bypass = 1;
+    }
+    return (unsigned short) (size_class * 2 + bypass);
+}
 
 void CostLRUEviction::update_size_running_mean(CostLRUEvictionEntry* node) {
     unsigned long size = node->data;
@@ -549,132 +607,134 @@ void CostLRUEviction::update_size_running_mean(CostLRUEvictionEntry* node) {
     running_size_var = (alpha_running_size_var * current_var) + ((1 - alpha_running_size_var) * running_size_var);
 }
 
-void CostLRUEviction::compute_scores() {
+double CostLRUEviction::compute_score(CostLRUEvictionEntry* currentNode) {
     int size_formula = 1; // 1 is linear; 2 is cubic root (refer slides)
     int age_formula = 1;  // 1 is linear; 2 is cubic
     int deviations = 4;
 
-    // here we compute the scores right before we begin the hourly eviction cycle
+    // scores are computed against the current running size mean/variance
     double upper_range = running_size_mu + deviations * sqrt(running_size_var);
     double lower_range = running_size_mu - deviations * sqrt(running_size_var);
-
-    CostLRUEvictionEntry *currentNode = tail;
-    for (currentNode = currentNode->prev; currentNode != head; currentNode = currentNode->prev) {
-        double size_score = 0;
-        if (log2(currentNode->data) >= upper_range) {
-            size_score = 1;
-        } else if (log2(currentNode->data) <= lower_range) {
-            size_score = 0;
-        } else {
-            if (1 == size_formula) {
-                size_score = 0.5 + ((log2(currentNode->data) - running_size_mu) / (2 * deviations * sqrt(running_size_var)));
-            }
-            else if (2 == size_formula) {
-                double value = (log2(currentNode->data) - running_size_mu) / (2 * deviations * sqrt(running_size_var));
-                size_score = (cbrt(value) + cbrt(0.5)) * 1/6.0;
-            }
+    // and against the current age range of the cache
+    unsigned long age_range = head->next->timestamp - tail->prev->timestamp;
+
+    double size_score = 0;
+    if (log2(currentNode->data) >= upper_range) {
+        size_score = 1;
+    } else if (log2(currentNode->data) <= lower_range) {
+        size_score = 0;
+    } else {
+        if (1 == size_formula) {
+            size_score = 0.5 + ((log2(currentNode->data) - running_size_mu) / (2 * deviations * sqrt(running_size_var)));
         }
-
-        if (size_score > 1 || size_score < 0) {
-            cerr << "\nsize_scoreError "
-                << running_size_mu << " "
-                << running_size_var << " "
-                << size_score << " "
-                << log2(currentNode->data) << " ua "
-                << upper_range << " "
-                << 6*sqrt(running_size_var) << " "
-                << currentNode->data << " "
-                << currentNode->orig_url << " "
-                << currentNode->key
-                ;
-            exit(1);
+        else if (2 == size_formula) {
+            double value = (log2(currentNode->data) - running_size_mu) / (2 * deviations * sqrt(running_size_var));
+            size_score = (cbrt(value) + cbrt(0.5)) * 1/6.0;
         }
+    }
 
-        double age_score = 0;
-        if (1 == age_formula) {
-            age_score = (double) (head->next->timestamp - currentNode->timestamp) / (head->next->timestamp - tail->prev->timestamp);
-        }
-        else if (2 == age_formula) {
-            age_score = (double) (head->next->timestamp - currentNode->timestamp) / (head->next->timestamp - tail->prev->timestamp);
-            age_score = pow(age_score, 3);
-        }
-        else {
-            cout << "\nUndefined value of age_formula. Exiting.\n";
-            exit(1);
-        }
+    if (size_score > 1 || size_score < 0) {
+        cerr << "\nsize_scoreError "
+            << running_size_mu << " "
+            << running_size_var << " "
+            << size_score << " "
+            << log2(currentNode->data) << " ua "
+            << upper_range << " "
+            << 6*sqrt(running_size_var) << " "
+            << currentNode->data << " "
+            << currentNode->orig_url << " "
+            << currentNode->key
+            ;
+        exit(1);
+    }
 
-        if (age_score < 0 || age_score > 1) {
-            cout << "\nage_score value error.\n";
-            exit(1);
-        }
+    double age_score = 0;
+    if (0 == age_range) {
+        age_score = 0; // everything has the same age
+    }
+    else if (1 == age_formula) {
+        age_score = (double) (head->next->timestamp - currentNode->timestamp) / age_range;
+    }
+    else if (2 == age_formula) {
+        age_score = (double) (head->next->timestamp - currentNode->timestamp) / age_range;
+        age_score = pow(age_score, 3);
+    }
+    else {
+        cout << "\nUndefined value of age_formula. Exiting.\n";
+        exit(1);
+    }
 
-        double eviction_score = 0;
-        if (1 == eviction_formula) {
-            eviction_score = (age_score * w_age) + (size_score * w_size); // higher score = evicted sooner
-        }
+    if (age_score < 0 || age_score > 1) {
+        cout << "\nage_score value error.\n";
+        exit(1);
+    }
 
-        else if (2 == eviction_formula) {
-            double saiflish_perf = 0.5; // default is 0.5, else 1.0.
-            bool _b = sci->check_customer_in_list(currentNode->customer_id, sci->no_bf_cust);
-            if(_b) {
-                // this content was added on 1st hit
-                // so we will push these guys further towards the end
-                saiflish_perf = 1;
-            }
-            eviction_score = ((age_score * w_age) + (size_score * w_size)) * saiflish_perf; // higher score = evicted sooner
-        }
+    double eviction_score = 0;
+    if (1 == eviction_formula) {
+        eviction_score = (age_score * w_age) + (size_score * w_size); // higher score = evicted sooner
+    }
 
-        else if (3 == eviction_formula) {
-            eviction_score = (head->next->timestamp - currentNode->timestamp) * (size_score * w_size); // higher score = evicted sooner
+    else if (2 == eviction_formula) {
+        double saiflish_perf = 0.5; // default is 0.5, else 1.0.
+        bool _b = (currentNode->score_class & 1); // bypass bit of the score class
+        if(_b) {
+            // this content was added on 1st hit
+            // so we will push these guys further towards the end
+            saiflish_perf = 1;
         }
+        eviction_score = ((age_score * w_age) + (size_score * w_size)) * saiflish_perf; // higher score = evicted sooner
+    }
 
-        else if (4 == eviction_formula) {
-            // A_i^y * (S_i * w + E)
-            eviction_score = pow((head->next->timestamp - currentNode->timestamp), ef4_y)
-                * ((size_score * w_size) + ef4_e); // higher score = evicted sooner
-        }
-        else if (5 == eviction_formula) {
-            // A_i^y * (S_i * w + A_i)
-            eviction_score = pow((head->next->timestamp - currentNode->timestamp), ef4_y)
-                * ((size_score * w_size) + (head->next->timestamp - currentNode->timestamp)); // higher score = evicted sooner
-        }
+    else if (3 == eviction_formula) {
+        eviction_score = (head->next->timestamp - currentNode->timestamp) * (size_score * w_size); // higher score = evicted sooner
+    }
 
-        else if (6 == eviction_formula) {
-            // A_i^y + (S_i * w * A_i)
-            eviction_score = pow((head->next->timestamp - currentNode->timestamp), ef4_y)
-                + ((size_score * w_size) * (head->next->timestamp - currentNode->timestamp)); // higher score = evicted sooner
-        }
+    else if (4 == eviction_formula) {
+        // A_i^y * (S_i * w + E)
+        eviction_score = pow((head->next->timestamp - currentNode->timestamp), ef4_y)
+            * ((size_score * w_size) + ef4_e); // higher score = evicted sooner
+    }
+    else if (5 == eviction_formula) {
+        // A_i^y * (S_i * w + A_i)
+        eviction_score = pow((head->next->timestamp - currentNode->timestamp), ef4_y)
+            * ((size_score * w_size) + (head->next->timestamp - currentNode->timestamp)); // higher score = evicted sooner
+    }
 
-        else if (7 == eviction_formula) {
-            // A_i^y  * (w_s * A_0 * S + e)
-            eviction_score = pow((head->next->timestamp - currentNode->timestamp), ef4_y)
-                * ((size_score * w_size * (head->next->timestamp - tail->prev->timestamp)) + ef4_e); // higher score = evicted sooner
-        }
+    else if (6 == eviction_formula) {
+        // A_i^y + (S_i * w * A_i)
+        eviction_score = pow((head->next->timestamp - currentNode->timestamp), ef4_y)
+            + ((size_score * w_size) * (head->next->timestamp - currentNode->timestamp)); // higher score = evicted sooner
+    }
 
-        else if (8 == eviction_formula) {
-            // same as eviction_formula 1, but every lru_interval hours we do a regular LRU
-            if (0 == hour_count % lru_interval) {
-                eviction_score = age_score;
-                //cout << ".";
-            }
-            else {
-                eviction_score = (age_score * w_age) + (size_score * w_size); // higher score = evicted sooner
-               // cout << "*";
-            }
-        }
+    else if (7 == eviction_formula) {
+        // A_i^y  * (w_s * A_0 * S + e)
+        eviction_score = pow((head->next->timestamp - currentNode->timestamp), ef4_y)
+            * ((size_score * w_size * (head->next->timestamp - tail->prev->timestamp)) + ef4_e); // higher score = evicted sooner
+    }
 
-        else {
-            cout << "\nUndefined value of eviction_formula. Exiting.\n";
-            exit(1);
+    else if (8 == eviction_formula) {
+        // same as eviction_formula 1, but every lru_interval hours we do a regular LRU
+        if (0 == hour_count % lru_interval) {
+            eviction_score = age_score;
+            //cout << ".";
         }
-        if (sci->debug) {
-            cout << "hour_count " << hour_count << " " << head->next->timestamp
-                << " d_t " << (head->next->timestamp - currentNode->timestamp)
-                << " " << currentNode->key << " s " << currentNode->data
-                << " as " << age_score << " ss " << size_score << " es " << eviction_score << "\n";
+        else {
+            eviction_score = (age_score * w_age) + (size_score * w_size); // higher score = evicted sooner
+           // cout << "*";
         }
-        m_item_unordered_map[currentNode->key].score = eviction_score;
     }
+
+    else {
+        cout << "\nUndefined value of eviction_formula. Exiting.\n";
+        exit(1);
+    }
+    if (sci->debug) {
+        cout << "hour_count " << hour_count << " " << head->next->timestamp
+            << " d_t " << (head->next->timestamp - currentNode->timestamp)
+            << " " << currentNode->key << " s " << currentNode->data
+            << " as " << age_score << " ss " << size_score << " es " << eviction_score << "\n";
+    }
+    return eviction_score;
 }
 
 void CostLRUEviction::update_cost_based_score(CostLRUEvictionEntry* node) {
@@ -733,67 +793,125 @@ void CostLRUEviction::update_cost_based_score(CostLRUEvictionEntry* node) {
 
 void CostLRUEviction::detach(CostLRUEvictionEntry* node)
 {
+    customer_recency.detach(node);
+    if (node->in_window) {
+        if (node->window_it != size_window.end()) {
+            size_window.erase(node->window_it);
+        }
+        if (node == window_front) {
+            window_front = node->next;
+        }
+        node->in_window = false;
+        --window_span;
+    }
+
     node->prev->next = node->next;
     node->next->prev = node->prev;
     current_size = current_size - node->data;
+
+    // Leave the score class, clear its bit if it is now empty
+    unsigned short c = node->score_class;
+    node->class_prev->class_next = node->class_next;
+    node->class_next->class_prev = node->class_prev;
+    if (class_head[c]->class_next == class_tail[c]) {
+        class_bitmap[c / 64] &= ~(1ULL << (c % 64));
+    }
 }
 
 void CostLRUEviction::attach(CostLRUEvictionEntry* node)
 {
+    customer_recency.attach(node);
+    node->in_window = false;
     node->next = head->next;
     node->prev = head;
     head->next = node;
     node->next->prev = node;
     current_size = current_size + node->data;
+
+    // Also the most recent entry of its score class
+    unsigned short c = get_score_class(node);
+    node->score_class = c;
+    node->class_next = class_head[c]->class_next;
+    node->class_prev = class_head[c];
+    class_head[c]->class_next = node;
+    node->class_next->class_prev = node;
+    class_bitmap[c / 64] |= (1ULL << (c % 64));
 }
 
 void CostLRUEviction::purge_size_based_multimap() {
-    if (cache_item_count < purge_size_based_limit) {
-        cerr << "cache_item_count " << cache_item_count
-            << ", is less than purge_size_based_limit " << purge_size_based_limit << endl;
-        cerr << "Setting purge_size_based_limit to half of cache_item_count." << endl;
-        purge_size_based_limit = cache_item_count / 2;
+    while (current_size > total_capacity && head->next != tail) {
+        purge_size_based();
     }
+}
 
-    unsigned long total_items_purged = 0;
-    std::multimap<unsigned long, string> size_based_purge_list;
+/*
+ * The window is only ever grown from its head side, so an entry enters it at
+ * most once per trip down the LRU list and each eviction costs O(log N).
+ */
+void CostLRUEviction::refill_size_window() {
+    while (window_span < purge_size_based_limit && window_front->prev != head) {
+        CostLRUEvictionEntry* node = window_front->prev;
+        window_front = node;
+        node->in_window = true;
+        ++window_span;
+        if (skip_size_based_deletion(node->customer_id)) {
+            node->window_it = size_window.end();
+        }
+        else {
+            node->window_it = size_window.insert(
+                std::pair<unsigned long, CostLRUEvictionEntry*>(node->data, node));
+        }
+    }
+}
 
-    CostLRUEvictionEntry* node = tail->prev;
-    size_based_purge_list.insert(std::pair<unsigned long, string>(node->data, node->key));
+/* Empties the window, the next refill starts over from the tail */
+void CostLRUEviction::reset_size_window() {
+    for (CostLRUEvictionEntry* node = window_front; node != tail; node = node->next) {
+        node->in_window = false;
+    }
+    size_window.clear();
+    window_front = tail;
+    window_span = 0;
+}
+
+bool CostLRUEviction::skip_size_based_deletion(const string& customer_id) {
+    return customer_recency.is_protected(customer_id);
+}
 
-    // populate the initial list
-    for(unsigned int i = 1; i < purge_size_based_limit; i++) {
-        node = node->prev;
-        //if (customer_hit_stats[node->customer_id]["skip_size_based_deletion"] != 1) {
-        // NOTE: For now, take it no matter what, don't worry about customer
-        size_based_purge_list.insert(std::pair<unsigned long, string>(node->data, node->key));
-        //    //	cout << "\nentry inserted " << node->key << " " << node->data << "\n";
-        //}
+void CostLRUEviction::purge_size_based() {
+    refill_size_window();
+
+    // every covered customer is protected, fall back to plain LRU
+    if (size_window.empty()) {
+        purge_regular();
+        return;
     }
 
-    //cout << endl << "current_size  " << current_size << " " << total_capacity << endl;
-    //cout << "size_based_purge_list.size() " << size_based_purge_list.size() << endl;
+    std::multimap<unsigned long, CostLRUEvictionEntry*>::iterator it = size_window.end(); it--;
+    evict(it->second);
+}
 
-    while (current_size > total_capacity) {
-        std::multimap<unsigned long, string>::iterator it = (size_based_purge_list.end()); it--;
-        //cout << "\nitem_to_delete " << it->first << " " << it->second << endl;
-        CostLRUEvictionEntry* node_to_delete = _mapping[it->second];
-
-        detach(node_to_delete);
-        _mapping.erase(node_to_delete->key);
-        delete node_to_delete;
-        size_based_purge_list.erase(it);
-        --cache_item_count;
-        total_items_purged++;
+void CostLRUEviction::evict(CostLRUEvictionEntry* node) {
+    detach(node);
+    _mapping.erase(node->key);
+    m_item_unordered_map.erase(node->key);
+    delete node;
+    --cache_item_count;
+}
 
-        node = node->prev;
-        if (customer_hit_stats[node->customer_id]["skip_size_based_deletion"] != 1) {
-            size_based_purge_list.insert(std::pair<unsigned long, string>(node->data, node->key));
-        }
+void CostLRUEviction::purge_customer_based_approx() {
+    CostLRUEvictionEntry* node = customer_recency.fair_victim();
+    if (node == NULL) {
+        purge_regular();
+        return;
+    }
+    evict(node);
+}
 
-        if (size_based_purge_list.size() <= 1) return;
+void CostLRUEviction::purge_customer_based() {
+    while (current_size > total_capacity && head->next != tail) {
+        purge_customer_based_approx();
     }
-    //cout << "total_items_purged by purge_size_based_multimap " << total_items_purged << endl;
 }
 
 string CostLRUEviction::return_customer_id(string url) {
@@ -808,49 +926,6 @@ string CostLRUEviction::return_customer_id(string url) {
     return v[3];
 }
 
-void CostLRUEviction::compute_periodic_stats(bool floor_customer_loss) {
-	typedef std::unordered_map<string, unsigned long> inner_map;
-	typedef std::unordered_map<string, inner_map> outer_map;
-
-	for (outer_map::iterator i = customer_hit_stats.begin(), iend = customer_hit_stats.end(); i != iend; ++i)
-	{
-		// i->first = customer ID (e.g. 307A)
-		if (customer_hit_stats[i->first]["periodic_hits_and_misses"] > 0) {
-			unsigned long periodic_hit_ratio = 100 * (float) customer_hit_stats[i->first]["periodic_hits"]
-												   / (float) customer_hit_stats[i->first]["periodic_hits_and_misses"];
-			customer_hit_stats[i->first]["periodic_hit_ratio"] = periodic_hit_ratio;
-		}
-
-		if (customer_hit_stats[i->first]["periodic_bytes_hit_and_miss"] > 0) {
-			unsigned long periodic_byte_hit_ratio = 100 * (float) customer_hit_stats[i->first]["periodic_bytes_hit"]
-												   / (float) customer_hit_stats[i->first]["periodic_bytes_hit_and_miss"];
-
-			if (floor_customer_loss == true) {
-				int diff = periodic_byte_hit_ratio - customer_hit_stats[i->first]["periodic_byte_hit_ratio"];
-				if (diff > 100) {
-					cerr << "compute_periodic_stats(): diff > 100" << __LINE__ << " " << __FILE__;
-					exit(1);
-				}
-				else if (diff <= -2 && customer_hit_stats[i->first]["skip_size_based_deletion"] != 1) {
-					// the ratio reduced more than 2% since last time. so we need to protect the customer
-					customer_hit_stats[i->first]["skip_size_based_deletion"] = 1;
-				}
-				else if (diff >= 1 && customer_hit_stats[i->first]["skip_size_based_deletion"] != 0) {
-					// things got better, so no need to protect them.
-					customer_hit_stats[i->first]["skip_size_based_deletion"] = 0;
-				}
-			}
-
-			customer_hit_stats[i->first]["periodic_byte_hit_ratio"] = periodic_byte_hit_ratio;
-		}
-
-		customer_hit_stats[i->first]["periodic_hits"] = 0;
-		customer_hit_stats[i->first]["periodic_bytes_hit"] = 0;
-		customer_hit_stats[i->first]["periodic_hits_and_misses"] = 0;
-		customer_hit_stats[i->first]["periodic_bytes_hit_and_miss"] = 0;
-	}
-}
-
 void CostLRUEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
     double oldest_file_age;
 
@@ -865,4 +940,7 @@ void CostLRUEviction::periodic_output(unsigned long ts, std::ostringstream& outl
     oldest_file_age = ((float) ts - tail->prev->timestamp)/60/60/24;
     outlogfile << oldest_file_age << " ";
 
+    // Monitored customers: oldest file age (days), bytes, objects
+    customer_recency.periodic_output(sci->monitor_customers_list, ts, outlogfile);
+
 }
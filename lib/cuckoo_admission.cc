@@ -0,0 +1,224 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+/*
+ * N-hit Caching Cache Admission Policy over a cuckoo filter
+ *
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include "hashfunc.h"
+#include "cache_policy.h"
+#include "cuckoo_admission.h"
+
+using namespace std;
+
+CuckooAdmission::CuckooAdmission(unsigned long capacity, int _NVAL, vector<string> no_bf_cust,
+                                 unsigned long max_age, bool delete_on_admit) {
+    name = "cuckoo";
+    this->no_bf_cust = no_bf_cust;
+    this->delete_on_admit = delete_on_admit;
+
+    if (_NVAL < 1 || _NVAL > CUCKOO_COUNTER_MAX) {
+        cerr << "\nCuckooAdmission: N value " << _NVAL << " out of range 1.."
+            << CUCKOO_COUNTER_MAX << ". Exiting.\n";
+        exit(1);
+    }
+    NVAL = _NVAL;
+
+    // round the buckets up to a power of 2
+    unsigned long buckets = 1;
+    while (buckets * CUCKOO_SLOTS_PER_BUCKET < capacity) {
+        buckets <<= 1;
+    }
+    bucket_mask = buckets - 1;
+    slots.assign(buckets * CUCKOO_SLOTS_PER_BUCKET, 0);
+
+    epoch_len = max_age / CUCKOO_EPOCHS_PER_AGE;
+    if (epoch_len == 0) {
+        epoch_len = 1;
+    }
+    first_ts = 0;
+    current_epoch = 0;
+    sweep_bucket = 0;
+    occupied = 0;
+
+    admitted = 0;
+    rejected = 0;
+    expired = 0;
+    dropped = 0;
+}
+
+CuckooAdmission::~CuckooAdmission() {
+}
+
+uint32_t* CuckooAdmission::find(unsigned long b1, unsigned long b2, uint32_t fp) {
+    uint32_t* s = &slots[b1 * CUCKOO_SLOTS_PER_BUCKET];
+    for (int i = 0; i < CUCKOO_SLOTS_PER_BUCKET; i++) {
+        if (s[i] != 0 && fingerprint(s[i]) == fp) {
+            return &s[i];
+        }
+    }
+    s = &slots[b2 * CUCKOO_SLOTS_PER_BUCKET];
+    for (int i = 0; i < CUCKOO_SLOTS_PER_BUCKET; i++) {
+        if (s[i] != 0 && fingerprint(s[i]) == fp) {
+            return &s[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Free or expired slot in either bucket, else kick entries to their other
+ * bucket. Returns false if an entry had to be dropped after CUCKOO_MAX_KICKS.
+ */
+bool CuckooAdmission::insert(unsigned long b1, unsigned long b2, uint32_t slot) {
+    unsigned long buckets[2] = {b1, b2};
+    for (int b = 0; b < 2; b++) {
+        uint32_t* s = &slots[buckets[b] * CUCKOO_SLOTS_PER_BUCKET];
+        for (int i = 0; i < CUCKOO_SLOTS_PER_BUCKET; i++) {
+            if (s[i] == 0) {
+                s[i] = slot;
+                occupied++;
+                return true;
+            }
+            if (is_expired(s[i])) {
+                s[i] = slot;
+                expired++;
+                return true;
+            }
+        }
+    }
+
+    unsigned long bucket = buckets[rng.below(2)];
+    for (int kick = 0; kick < CUCKOO_MAX_KICKS; kick++) {
+        uint32_t* victim = &slots[bucket * CUCKOO_SLOTS_PER_BUCKET + rng.below(CUCKOO_SLOTS_PER_BUCKET)];
+        std::swap(slot, *victim);
+
+        bucket = alt_bucket(bucket, fingerprint(slot));
+        uint32_t* s = &slots[bucket * CUCKOO_SLOTS_PER_BUCKET];
+        for (int i = 0; i < CUCKOO_SLOTS_PER_BUCKET; i++) {
+            if (s[i] == 0 || is_expired(s[i])) {
+                if (s[i] == 0) {
+                    occupied++;
+                }
+                else {
+                    expired++;
+                }
+                s[i] = slot;
+                return true;
+            }
+        }
+    }
+    dropped++;
+    return false;
+}
+
+/* Clears the expired slots of one bucket per request */
+void CuckooAdmission::sweep_one_bucket() {
+    uint32_t* s = &slots[sweep_bucket * CUCKOO_SLOTS_PER_BUCKET];
+    for (int i = 0; i < CUCKOO_SLOTS_PER_BUCKET; i++) {
+        if (s[i] != 0 && is_expired(s[i])) {
+            s[i] = 0;
+            occupied--;
+            expired++;
+        }
+    }
+    sweep_bucket = (sweep_bucket + 1) & bucket_mask;
+}
+
+// Should we let this in?
+bool CuckooAdmission::check(string key, unsigned long data, unsigned long long size,
+                            unsigned long ts, string customer_id_str) {
+
+    // Check to see if this customer bypasses the filter. If so, just let
+    // it in
+    if (check_customer_in_list(customer_id_str)) {
+        return true;
+    }
+
+    if (first_ts == 0) {
+        first_ts = ts;
+    }
+    current_epoch = ((ts - first_ts) / epoch_len) & CUCKOO_EPOCH_MASK;
+    sweep_one_bucket();
+
+    uint64_t h[2];
+    murmur3_128(key.c_str(), key.size(), 0, h);
+    uint32_t fp = (uint32_t) (h[1] & 0xFFFF);
+    if (fp == 0) {
+        fp = 1; // 0 marks an empty slot
+    }
+    unsigned long b1 = h[0] & bucket_mask;
+    unsigned long b2 = alt_bucket(b1, fp);
+
+    uint32_t* s = find(b1, b2, fp);
+    if (s != NULL && !is_expired(*s)) {
+        if (counter(*s) >= (uint32_t) NVAL) {
+            admitted++;
+            if (delete_on_admit) {
+                *s = 0;
+                occupied--;
+            }
+            else {
+                *s = make_slot(fp, counter(*s), current_epoch);
+            }
+            return true;
+        }
+        *s = make_slot(fp, counter(*s) + 1, current_epoch);
+        rejected++;
+        return false;
+    }
+
+    // New (or aged out) key, first sighting
+    if (s != NULL) {
+        *s = make_slot(fp, 1, current_epoch);
+        expired++;
+    }
+    else {
+        insert(b1, b2, make_slot(fp, 1, current_epoch));
+    }
+    rejected++;
+    return false;
+}
+
+bool CuckooAdmission::check_customer_in_list(string custid) const{
+    if(std::find(no_bf_cust.begin(), no_bf_cust.end(), custid) != no_bf_cust.end())
+        return true;
+    else
+        return false;
+}
+
+float CuckooAdmission::get_fill_percentage() {
+    return 100.0 * occupied / slots.size();
+}
+
+float CuckooAdmission::get_fpr_percentage() {
+    // a lookup compares against 2 buckets worth of 16 bit fingerprints
+    double load = (double) occupied / slots.size();
+    return 100.0 * (1 - pow(1 - 1.0 / 65536, 2 * CUCKOO_SLOTS_PER_BUCKET * load));
+}
+
+void CuckooAdmission::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_fill_percentage() << " "
+        << get_fpr_percentage() << " "
+        << occupied << " "
+        << admitted << " "
+        << rejected << " "
+        << expired << " "
+        << dropped << " ";
+
+    admitted = 0;
+    rejected = 0;
+    expired = 0;
+    dropped = 0;
+}
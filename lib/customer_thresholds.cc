@@ -0,0 +1,79 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+/*
+ * Per customer admission thresholds
+ *
+ */
+
+#include <stdlib.h>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <unordered_map>
+
+#include "customer_thresholds.h"
+
+using namespace std;
+
+void CustomerThresholds::set(const string& customer_id, int nval, unsigned long long max_size) {
+    CustomerThreshold* t;
+    int id = dense_id(customer_id);
+    if (id >= 0) {
+        if (by_dense_id.empty()) {
+            by_dense_id.resize(CUSTOMER_DENSE_IDS);
+        }
+        t = &by_dense_id[id];
+    }
+    else {
+        t = &by_name[customer_id];
+    }
+    if (t->nval < 0) {
+        customers.push_back(customer_id);
+    }
+    t->nval = nval;
+    t->max_size = max_size;
+}
+
+bool CustomerThresholds::parse(const string& spec) {
+    istringstream entries(spec);
+    string entry;
+    while (getline(entries, entry, ',')) {
+        vector<string> fields;
+        istringstream ss(entry);
+        string field;
+        while (getline(ss, field, ':')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 2 || fields.size() > 3 || fields[0].empty()) {
+            return false;
+        }
+
+        char* end;
+        long nval = strtol(fields[1].c_str(), &end, 10);
+        if (*end != '\0' || fields[1].empty() || nval < 0 || nval > CUSTOMER_MAX_NVAL) {
+            return false;
+        }
+        unsigned long long max_size = 0;
+        if (fields.size() == 3) {
+            max_size = strtoull(fields[2].c_str(), &end, 10);
+            if (*end != '\0' || fields[2].empty()) {
+                return false;
+            }
+        }
+        set(fields[0], (int) nval, max_size);
+    }
+    return true;
+}
+
+void CustomerThresholds::print(ostream& out) const {
+    for (size_t i = 0; i < customers.size(); i++) {
+        const CustomerThreshold* t = find(customers[i]);
+        out << customers[i] << ':' << t->nval;
+        if (t->max_size) {
+            out << ':' << t->max_size;
+        }
+        out << ' ';
+    }
+}
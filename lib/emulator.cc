@@ -12,9 +12,11 @@
 #include <vector>
 
 #include "status.h"
+#include "prng.h"
 #include "bloomfilter.h"
 #include "em_structs.h"
 #include "cache.h"
+#include "next_access.h"
 #include "emulator.h"
 
 using namespace std;
@@ -216,6 +218,7 @@ Emulator::Emulator(ostream &output_file, bool partial_object,
     sci->command_line_parser(argc, argv);
     // Dump out the conf items 
     sci->print_em_conf_items();
+    seed_state = sci->seed;
     // If debug is on, harp a little so we are warned about how much comes out
     if (sci->debug) {
         cerr << "\nDebug mode is on, too much output will be produced.\n";
@@ -240,6 +243,7 @@ Emulator::Emulator(ostream &output_file, bool partial_object,
 
     tail = NULL;
     head = NULL;
+    oracle = NULL;
 
     front_end_mode = false;
 
@@ -257,6 +261,7 @@ Emulator::Emulator(string input_config_file, ostream &output_file,
     sci->config_file_parser(input_config_file);
     // Dump out the conf items 
     sci->print_em_conf_items();
+    seed_state = sci->seed;
     // If debug is on, harp a little so we are warned about how much comes out
     if (sci->debug) {
         cerr << "\nDebug mode is on, too much output will be produced.\n";
@@ -284,6 +289,7 @@ Emulator::Emulator(string input_config_file, ostream &output_file,
 
     tail = NULL;
     head = NULL;
+    oracle = NULL;
 
 }
 
@@ -308,6 +314,9 @@ void Emulator::set_front_end_mode() {
 /* Given a new cache object, add it to the tail*/
 void Emulator::add_to_tail(Cache* new_cache){
 
+    // Its policies get their own random streams, fixed by the run's seed
+    new_cache->set_seed(splitmix64(seed_state));
+
     // If this is the first one, just set it
     if (tail == NULL) {
         // Set the tail, zero out next
@@ -329,13 +338,14 @@ void Emulator::add_to_tail(Cache* new_cache){
 
 /* 
  *
- * Process a single log line
+ * Parse a single log line into ip_inst, same return values as
+ * process_access_log_line (3 if it is to be processed)
  *
  */
-int Emulator::process_access_log_line(string log_line) {
-    item_packet ip_inst; //Item packet we will use for each iteration
+int Emulator::parse_access_log_line(string log_line, item_packet& ip_inst) {
     ip_inst = item_packet();
     ip_inst.line = log_line;
+    ip_inst.next_access = NEXT_ACCESS_NEVER;
 
     if (ip_inst.line.length() > 0)
     {
@@ -410,10 +420,6 @@ int Emulator::process_access_log_line(string log_line) {
                 && ip_inst.status_code_number >= 200
                 && ip_inst.status_code_number <= 400) {
 
-            // Flag to note if we've looked at the line, seems to be for
-            // accounting
-            bool process_line = true;
-
             if ((partial_object_caching == true) && (ip_inst.status_code_number == 206)) {
                 ip_inst.city64_str = url_cachekey_partial(ip_inst.url,
                                                           ip_inst.line);
@@ -424,83 +430,92 @@ int Emulator::process_access_log_line(string log_line) {
                 ip_inst.city64_str = url_cachekey(ip_inst.url, 1);
             }
 
-            if (process_line) {
-                if (sci->debug) {
-                    output << "\npopulate_access_log_cache4 " << ip_inst.url;
-                    output << "\n" << ip_inst.city64_str << endl << ip_inst.city64_str_unmodified << endl;
-                }
-                // Counter
-                rv_inst->number_of_urls++;
-
-                // Does some work to tokenize the URL
-                std::vector<std::string> v; // http://rosettacode.org/wiki/Tokenize_a_string#C.2B.2B
-                std::istringstream buf(ip_inst.url);
-                for (std::string token; getline(buf, token, '/');) {
-                    v.push_back(token);
-                }
-                if ((v.size() > 3) && (v[3].length() == 6)) {
-                    //cout << ip_inst.url << endl;
-                    ip_inst.customer_id = v[3].substr(2, 4);
-                }
-                else {
-                    // If no customer ID, take 0
-                    ip_inst.customer_id = "0";
-                }
-
-                /*processed_urls->initial_put(ip_inst.city64_str,
-                  ip_inst.size, ip_inst.ts,
-                  ip_inst.bytes_out, ip_inst.customer_id,
-                  ip_inst.url, ip_inst.line);*/
-
-                //lookup_update_kc_hdd_cache(sci, rv_inst, &ip_inst, csp_inst, cache_kc_main,
-                //        cache_hdd_main, 1, 1, requested_item_map);
-
-                // Handle the infinite cache
-                // store statistics for unlimited cache
-                string cache_key = ip_inst.city64_str;
-                if(requested_item_map[cache_key] == true) {
-                    requested_item_map_hit++;
-                    requested_item_map_hit_bytes += ip_inst.size;
-                } else {
-                    requested_item_map_miss++;
-                    requested_item_map_miss_bytes += ip_inst.size;
-                    requested_item_map[cache_key] = true;
-                }
-
-                csp_inst->traffic += ip_inst.size;
-
-                // Call out to the head cache object
-                head->process(&ip_inst);
-                // Logging stuff
-                execute_periodic_functions(&ip_inst);
-
-                return 3;
+            // Does some work to tokenize the URL
+            std::vector<std::string> v; // http://rosettacode.org/wiki/Tokenize_a_string#C.2B.2B
+            std::istringstream buf(ip_inst.url);
+            for (std::string token; getline(buf, token, '/');) {
+                v.push_back(token);
+            }
+            if ((v.size() > 3) && (v[3].length() == 6)) {
+                //cout << ip_inst.url << endl;
+                ip_inst.customer_id = v[3].substr(2, 4);
             }
-
             else {
-                /*unprocessed_urls->initial_put(ip_inst.city64_str,
-                  ip_inst.size, ip_inst.ts,
-                  ip_inst.bytes_out, ip_inst.customer_id,
-                  ip_inst.url, ip_inst.line);*/
-                output << "lines_unprocessed " << ip_inst.line
-                    << endl;
-                return 1;
+                // If no customer ID, take 0
+                ip_inst.customer_id = "0";
             }
+
+            return 3;
         } else {
             return 2;
-            /*skipped_urls->initial_put(ip_inst.city64_str,
-              ip_inst.size, ip_inst.ts,
-              ip_inst.bytes_out, ip_inst.customer_id,
-              ip_inst.url, ip_inst.line);*/
         }
-        // We don't need to do this, it will just write over
-        //delete ip_inst;
-        //ip_inst = new item_packet();
     } else {
-        output << "line.length() <= 0" << endl;
         return 0;
     }
+}
+
+/* 
+ *
+ * Process a single log line
+ *
+ */
+int Emulator::process_access_log_line(string log_line) {
+    item_packet ip_inst; //Item packet we will use for each iteration
+    int ret_val = parse_access_log_line(log_line, ip_inst);
+
+    if (ret_val != 3) {
+        if (ip_inst.line.length() == 0) {
+            output << "line.length() <= 0" << endl;
+        }
+        /*skipped_urls->initial_put(ip_inst.city64_str,
+          ip_inst.size, ip_inst.ts,
+          ip_inst.bytes_out, ip_inst.customer_id,
+          ip_inst.url, ip_inst.line);*/
+        return ret_val;
+    }
 
+    if (sci->debug) {
+        output << "\npopulate_access_log_cache4 " << ip_inst.url;
+        output << "\n" << ip_inst.city64_str << endl << ip_inst.city64_str_unmodified << endl;
+    }
+    // Counter
+    rv_inst->number_of_urls++;
+
+    // Offline runs know when this key comes back
+    if (oracle != NULL) {
+        oracle->next(ip_inst.request, ip_inst.next_access);
+    }
+
+    /*processed_urls->initial_put(ip_inst.city64_str,
+      ip_inst.size, ip_inst.ts,
+      ip_inst.bytes_out, ip_inst.customer_id,
+      ip_inst.url, ip_inst.line);*/
+
+    // Handle the infinite cache
+    // store statistics for unlimited cache
+    string cache_key = ip_inst.city64_str;
+    if(requested_item_map[cache_key] == true) {
+        requested_item_map_hit++;
+        requested_item_map_hit_bytes += ip_inst.size;
+    } else {
+        requested_item_map_miss++;
+        requested_item_map_miss_bytes += ip_inst.size;
+        requested_item_map[cache_key] = true;
+    }
+
+    csp_inst->traffic += ip_inst.size;
+
+    // Call out to the head cache object
+    head->process(&ip_inst);
+    // Logging stuff
+    execute_periodic_functions(&ip_inst);
+
+    return 3;
+}
+
+/* Requests carry their next access time from now on */
+void Emulator::set_next_access_oracle(NextAccessOracle* new_oracle) {
+    oracle = new_oracle;
 }
 
 /* 
@@ -509,6 +524,10 @@ int Emulator::process_access_log_line(string log_line) {
  *
  */
 void Emulator::populate_access_log_cache() {
+    populate_access_log_cache(cin);
+}
+
+void Emulator::populate_access_log_cache(istream& in) {
     unsigned long long lines_processed = 0; // access log entry contained a valid cache key
     unsigned long long lines_unprocessed = 0;// access log entry contained NO valid cache key
     unsigned long long lines_skipped = 0;
@@ -524,7 +543,7 @@ void Emulator::populate_access_log_cache() {
     string curr_line;
     int ret_val;
 
-    while (getline(cin, curr_line))
+    while (getline(in, curr_line))
     {
         ret_val = process_access_log_line(curr_line);
 
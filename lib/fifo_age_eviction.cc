@@ -74,6 +74,11 @@ FIFOAgeEviction::FIFOAgeEviction(unsigned long long size, string id, unsigned lo
 
     this->ttl = ttl;
 
+    expired_count = 0;
+    expired_bytes = 0;
+    evicted_count = 0;
+    evicted_bytes = 0;
+
 }
 
 FIFOAgeEviction::~FIFOAgeEviction()
@@ -232,24 +237,10 @@ void FIFOAgeEviction::print_oldest_file_age_for_monitored_customers(unsigned lon
     }
     cout << endl;
     for(vector<string>::const_iterator i = sci->monitor_customers_list.begin(); i != sci->monitor_customers_list.end(); ++i) {
-        FIFOEvictionEntry* currentNode = tail;
-        bool item_found = false;
-        for (currentNode = currentNode->prev; currentNode != head; currentNode = currentNode->prev) {
-            if(currentNode->customer_id.compare(*i) == 0) {
-                item_found = true;
-                cout << "print_oldest_file_age_days "
-                    << *i << " "
-                    << (float) (currentTimeStamp - currentNode->timestamp)/60/60/24 // days
-                    << "\n";
-                break;
-            }
-        }
-        if(!item_found) {
-            cout << "print_oldest_file_age_days "
-                << *i << " "
-                << 0
-                << "\n";
-        }
+        cout << "print_oldest_file_age_days "
+            << *i << " "
+            << customer_recency.oldest_age_days(*i, currentTimeStamp) // days
+            << "\n";
     }
     cout << endl;
 }
@@ -400,17 +391,13 @@ int FIFOAgeEviction::check_and_print(string key)	// to check if present.
 
 int FIFOAgeEviction::check(string key, unsigned long ts)	// to check if present.
 {
+    expire_due(ts);
+
     FIFOEvictionEntry* node = _mapping[key];
     if(node) {
 
         if ((ts - node->timestamp) > ttl) {
-            detach(node);
-            _mapping.erase(node->key);
-            delete node;
-
-            --cache_item_count;
-
-
+            expire(node);
             return 0;
         }
 
@@ -420,6 +407,33 @@ int FIFOAgeEviction::check(string key, unsigned long ts)	// to check if present.
         return 0;
 }
 
+void FIFOAgeEviction::expire_due(unsigned long ts) {
+    due_timers.clear();
+    ttl_wheel.advance(ts, due_timers);
+
+    for (vector<FIFOEvictionEntry*>::iterator it = due_timers.begin(); it != due_timers.end(); ++it) {
+        FIFOEvictionEntry* node = *it;
+        // Hits push the deadline out without touching the wheel, catch up here
+        if ((ts - node->timestamp) > ttl) {
+            expire(node);
+        }
+        else {
+            ttl_wheel.schedule(node, node->timestamp + ttl + 1);
+        }
+    }
+}
+
+void FIFOAgeEviction::expire(FIFOEvictionEntry* node) {
+    expired_count++;
+    expired_bytes += node->data;
+
+    detach(node);
+    _mapping.erase(node->key);
+    delete node;
+
+    --cache_item_count;
+}
+
 unsigned long FIFOAgeEviction::manual_delete(string key) {
     FIFOEvictionEntry* node = _mapping[key];
     unsigned long data;
@@ -472,6 +486,9 @@ bool FIFOAgeEviction::purge_regular() {
     // FIFOEvictionEntry* headNode = head->next;
     // cout << "\npurge_regular " << headNode->timestamp << " " << node->timestamp << " " << node->data << " " << node->key << "\n";
 
+    evicted_count++;
+    evicted_bytes += node->data;
+
     detach(node);
     _mapping.erase(node->key);
     delete node;
@@ -541,6 +558,9 @@ void FIFOAgeEviction::set_total_capacity_by_value(unsigned long long size) {
 
 void FIFOAgeEviction::detach(FIFOEvictionEntry* node)
 {
+    customer_recency.detach(node);
+    ttl_wheel.cancel(node);
+
     node->prev->next = node->next;
     node->next->prev = node->prev;
     current_size = current_size - node->data;
@@ -548,12 +568,15 @@ void FIFOAgeEviction::detach(FIFOEvictionEntry* node)
 
 void FIFOAgeEviction::attach(FIFOEvictionEntry* node)
 {
+    customer_recency.attach(node);
     // XXX This adds to the head
     node->next = head->next;
     node->prev = head;
     head->next = node;
     node->next->prev = node;
     current_size = current_size + node->data;
+
+    ttl_wheel.schedule(node, node->timestamp + ttl + 1);
 }
 
 void FIFOAgeEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
@@ -570,5 +593,19 @@ void FIFOAgeEviction::periodic_output(unsigned long ts, std::ostringstream& outl
     oldest_file_age = ((float) ts - tail->prev->timestamp)/60/60/24;
     outlogfile << oldest_file_age << " ";
 
+    // TTL expiry vs. capacity eviction since the last report
+    outlogfile << expired_count << " "
+        << expired_bytes << " "
+        << evicted_count << " "
+        << evicted_bytes << " ";
+
+    expired_count = 0;
+    expired_bytes = 0;
+    evicted_count = 0;
+    evicted_bytes = 0;
+
+    // Monitored customers: oldest file age (days), bytes, objects
+    customer_recency.periodic_output(sci->monitor_customers_list, ts, outlogfile);
+
 }
 
@@ -0,0 +1,177 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Gradient boosted regression trees on binned features
+ *
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "gbt.h"
+
+using namespace std;
+
+double GBTModel::train(const vector<float>& x, const vector<float>& y,
+                       unsigned int n_features, const GBTParams& params) {
+    nodes.clear();
+    roots.clear();
+    base = 0;
+
+    size_t n = y.size();
+    if (n == 0) {
+        return 0;
+    }
+    assert(x.size() == n * n_features);
+
+    // Bin c holds edges[c - 1] < x <= edges[c], the last one everything above
+    vector<vector<float> > edges(n_features);
+    vector<unsigned char> bins(n * n_features);
+    vector<float> column(n);
+    for (unsigned int f = 0; f < n_features; f++) {
+        for (size_t i = 0; i < n; i++) {
+            column[i] = x[i * n_features + f];
+        }
+        sort(column.begin(), column.end());
+        for (size_t b = 1; b < GBT_BINS; b++) {
+            float v = column[b * n / GBT_BINS];
+            if ((edges[f].empty() || v > edges[f].back()) && v < column[n - 1]) {
+                edges[f].push_back(v);
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            bins[i * n_features + f] = lower_bound(edges[f].begin(), edges[f].end(),
+                                                   x[i * n_features + f]) - edges[f].begin();
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        base += y[i];
+    }
+    base /= n;
+
+    vector<float> prediction(n, base);
+    vector<float> residual(n);
+    vector<unsigned int> rows(n);
+    for (unsigned int t = 0; t < params.trees; t++) {
+        for (size_t i = 0; i < n; i++) {
+            residual[i] = y[i] - prediction[i];
+            rows[i] = i;
+        }
+        unsigned int root = grow(bins, edges, residual, rows, 0, n, 0, params);
+        roots.push_back(root);
+
+        for (size_t i = 0; i < n; i++) {
+            unsigned int k = root;
+            const float* row = &x[i * n_features];
+            while (nodes[k].feature >= 0) {
+                k = row[nodes[k].feature] <= nodes[k].threshold ? nodes[k].left : nodes[k].right;
+            }
+            prediction[i] += nodes[k].value;
+        }
+    }
+
+    double squared = 0;
+    for (size_t i = 0; i < n; i++) {
+        squared += (y[i] - prediction[i]) * (y[i] - prediction[i]);
+    }
+    return sqrt(squared / n);
+}
+
+/* Splits rows[begin, end) where it cuts the squared error most */
+unsigned int GBTModel::grow(const vector<unsigned char>& bins, const vector<vector<float> >& edges,
+                            const vector<float>& residual, vector<unsigned int>& rows,
+                            size_t begin, size_t end, unsigned int depth, const GBTParams& params) {
+    size_t n = end - begin;
+    double sum = 0;
+    for (size_t i = begin; i < end; i++) {
+        sum += residual[rows[i]];
+    }
+
+    unsigned int index = nodes.size();
+    GBTNode leaf;
+    leaf.feature = -1;
+    leaf.threshold = 0;
+    leaf.value = params.learning_rate * sum / n;
+    leaf.left = 0;
+    leaf.right = 0;
+    nodes.push_back(leaf);
+
+    if (depth >= params.depth || n < 2 * (size_t) params.min_leaf) {
+        return index;
+    }
+
+    unsigned int n_features = edges.size();
+    double parent = sum * sum / n;
+    double best_gain = 0;
+    int best_feature = -1;
+    unsigned int best_bin = 0;
+    double bin_sum[GBT_BINS];
+    size_t bin_count[GBT_BINS];
+    for (unsigned int f = 0; f < n_features; f++) {
+        if (edges[f].empty()) {
+            continue;
+        }
+        fill(bin_sum, bin_sum + GBT_BINS, 0.0);
+        fill(bin_count, bin_count + GBT_BINS, 0);
+        for (size_t i = begin; i < end; i++) {
+            unsigned int r = rows[i];
+            bin_sum[bins[r * n_features + f]] += residual[r];
+            bin_count[bins[r * n_features + f]]++;
+        }
+
+        double left_sum = 0;
+        size_t left_count = 0;
+        for (unsigned int b = 0; b < edges[f].size(); b++) {
+            left_sum += bin_sum[b];
+            left_count += bin_count[b];
+            if (left_count < params.min_leaf) {
+                continue;
+            }
+            if (n - left_count < params.min_leaf) {
+                break;
+            }
+            double right_sum = sum - left_sum;
+            double gain = left_sum * left_sum / left_count
+                + right_sum * right_sum / (n - left_count) - parent;
+            if (gain > best_gain) {
+                best_gain = gain;
+                best_feature = f;
+                best_bin = b;
+            }
+        }
+    }
+    if (best_feature < 0) {
+        return index;
+    }
+
+    size_t mid = begin;
+    for (size_t i = begin; i < end; i++) {
+        if (bins[rows[i] * n_features + best_feature] <= best_bin) {
+            swap(rows[i], rows[mid++]);
+        }
+    }
+
+    unsigned int left = grow(bins, edges, residual, rows, begin, mid, depth + 1, params);
+    unsigned int right = grow(bins, edges, residual, rows, mid, end, depth + 1, params);
+    nodes[index].feature = best_feature;
+    nodes[index].threshold = edges[best_feature][best_bin];
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+}
+
+float GBTModel::predict(const float* row) const {
+    float value = base;
+    for (size_t t = 0; t < roots.size(); t++) {
+        unsigned int k = roots[t];
+        while (nodes[k].feature >= 0) {
+            k = row[nodes[k].feature] <= nodes[k].threshold ? nodes[k].left : nodes[k].right;
+        }
+        value += nodes[k].value;
+    }
+    return value;
+}
@@ -0,0 +1,203 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * GreedyDual-Size-Frequency eviction on an indexed heap
+ *
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "gdsf_eviction.h"
+
+using namespace std;
+
+GDSFEviction::GDSFEviction(unsigned long long size, string id, const EmConfItems * sci) {
+    name = "gdsf";
+    this->sci = sci;
+
+    if (sci->gdsf_cost.compare("1") == 0) {
+        cost_mode = GDSF_COST_ONE;
+    } else if (sci->gdsf_cost.compare("size") == 0) {
+        cost_mode = GDSF_COST_SIZE;
+    } else if (sci->gdsf_cost.compare("origin") == 0) {
+        cost_mode = GDSF_COST_ORIGIN;
+    } else {
+        cerr << "\nUnknown gdsf_cost " << sci->gdsf_cost << ". Exiting.\n";
+        exit(1);
+    }
+
+    total_capacity = size;
+    cache_id = id;
+    current_size = 0;
+    clock = 0;
+    seq = 0;
+
+    evicted = 0;
+    evicted_bytes = 0;
+    evicted_cost = 0;
+    hit_bytes = 0;
+    saved_cost = 0;
+}
+
+GDSFEviction::~GDSFEviction()
+{
+    for (unordered_map<string, GDSFEvictionEntry*>::iterator it = _mapping.begin(); it != _mapping.end(); ++it) {
+        delete it->second;
+    }
+}
+
+double GDSFEviction::fetch_cost(const string& customer_id, unsigned long data) const {
+    switch (cost_mode) {
+        case GDSF_COST_ONE:
+            return 1;
+        case GDSF_COST_SIZE:
+            return data;
+        case GDSF_COST_ORIGIN: {
+            unordered_map<string, double>::const_iterator it = sci->origin_cost.find(customer_id);
+            return (it == sci->origin_cost.end() ? 1 : it->second) * data;
+        }
+    }
+    return 1;
+}
+
+void GDSFEviction::hourly_purging(unsigned long timestamp) {
+    while (current_size > total_capacity * .80) {
+        purge_regular();
+    }
+}
+
+unsigned long long GDSFEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    GDSFEvictionEntry* node = new GDSFEvictionEntry;
+    node->key = key;
+    node->customer_id = customer_id;
+    node->data = data;
+    node->timestamp = timestamp;
+    node->count = 1;
+    node->cost = fetch_cost(customer_id, data);
+    node->priority = priority(node);
+    node->seq = ++seq;
+    _mapping[key] = node;
+    heap.push(node);
+    current_size += data;
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity) {
+        purge_regular();
+    }
+    return current_size;
+}
+
+unsigned long GDSFEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, GDSFEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    GDSFEvictionEntry* node = it->second;
+    node->count++;
+    node->timestamp = ts;
+    node->priority = priority(node);
+    node->seq = ++seq;
+    heap.update(node);
+
+    hit_bytes += node->data;
+    saved_cost += node->cost;
+    return node->data;
+}
+
+int GDSFEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    return _mapping.find(key) != _mapping.end();
+}
+
+bool GDSFEviction::purge_regular() {
+    if (heap.empty()) {
+        return false;
+    }
+
+    GDSFEvictionEntry* node = heap.pop();
+    clock = node->priority;
+
+    evicted++;
+    evicted_bytes += node->data;
+    evicted_cost += node->cost;
+    current_size -= node->data;
+    _mapping.erase(node->key);
+    delete node;
+    return true;
+}
+
+/* Best first walk down the heap, the frontier holds the children seen so far */
+bool GDSFEviction::peek_victims(unsigned long long incoming, size_t max_victims,
+                                vector<pair<string, unsigned long> >& victims) {
+    victims.clear();
+    if (heap.empty() || current_size + incoming <= total_capacity) {
+        return true;
+    }
+
+    GDSFLess less;
+    vector<size_t> frontier(1, 0);
+    unsigned long long freed = 0;
+    size_t scanned = 0;
+    while (!frontier.empty() && current_size + incoming - freed > total_capacity
+           && victims.size() < max_victims && scanned < GDSF_MAX_PEEK_SCAN) {
+        size_t best = 0;
+        for (size_t i = 1; i < frontier.size(); i++) {
+            if (less(heap.at(frontier[i]), heap.at(frontier[best]))) {
+                best = i;
+            }
+        }
+        size_t index = frontier[best];
+        frontier[best] = frontier.back();
+        frontier.pop_back();
+
+        GDSFEvictionEntry* node = heap.at(index);
+        victims.push_back(make_pair(node->key, node->data));
+        freed += node->data;
+        for (size_t c = index * heap.arity + 1; c <= index * heap.arity + heap.arity && c < heap.size(); c++) {
+            frontier.push_back(c);
+            scanned++;
+        }
+    }
+    return true;
+}
+
+unsigned long long GDSFEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long GDSFEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void GDSFEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << _mapping.size() << " "
+        << sci->gdsf_cost << " "
+        << clock << " "
+        << evicted << " "
+        << evicted_bytes << " "
+        << evicted_cost << " "
+        << hit_bytes << " "
+        << saved_cost << " ";
+
+    evicted = 0;
+    evicted_bytes = 0;
+    evicted_cost = 0;
+    hit_bytes = 0;
+    saved_cost = 0;
+}
@@ -0,0 +1,237 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+/*
+ * Learned Cache Admission Policy
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <string>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include "hashfunc.h"
+#include "cache_policy.h"
+#include "content_class.h"
+#include "learned_admission.h"
+
+using namespace std;
+
+/* 0 for 0, else 1 + floor(log2(v)), at most max */
+static inline unsigned int log2_bucket(unsigned long long v, unsigned int max) {
+    unsigned int b = 0;
+    while (v > 0 && b < max) {
+        v >>= 1;
+        b++;
+    }
+    return b;
+}
+
+/* Weight of the given value of feature f */
+static inline uint32_t weight_index(unsigned int f, uint64_t value) {
+    return fmix64(((uint64_t) f << 56) ^ value) & (LEARNED_ADMISSION_WEIGHTS - 1);
+}
+
+LearnedAdmission::LearnedAdmission(double threshold, unsigned long window_size,
+                                   vector<string> no_bf_cust) {
+    name = "learned";
+    this->no_bf_cust = no_bf_cust;
+    this->threshold = threshold;
+    auto_horizon = (window_size == 0);
+    horizon = auto_horizon ? LEARNED_ADMISSION_MIN_HORIZON : window_size;
+
+    weights.assign(LEARNED_ADMISSION_WEIGHTS, 0);
+    now = 0;
+    labels = 0;
+
+    admitted = 0;
+    rejected = 0;
+    admitted_hit = 0;
+    admitted_wasted = 0;
+    rejected_back = 0;
+    rejected_gone = 0;
+    loss = 0;
+    check_ns = 0;
+}
+
+LearnedAdmission::~LearnedAdmission() {
+}
+
+void LearnedAdmission::featurize(const LearnedAdmissionEntry& entry, unsigned long long size,
+                                 const string& key, const string& customer_id, uint32_t* features) const {
+    uint64_t size_class = log2_bucket(size, 63);
+    uint64_t customer = fingerprint(customer_id);
+    uint64_t content = content_class(key);
+    uint64_t seen = log2_bucket(entry.count, 7);
+    uint64_t recency = entry.count > 0 ? log2_bucket(now - entry.last_request, 31) : 0;
+
+    features[0] = weight_index(0, 0); // bias
+    features[1] = weight_index(1, size_class);
+    features[2] = weight_index(2, customer);
+    features[3] = weight_index(3, content);
+    features[4] = weight_index(4, seen);
+    features[5] = weight_index(5, recency);
+    features[6] = weight_index(6, content << 8 | size_class);
+    features[7] = weight_index(7, customer ^ fmix64(content));
+    features[8] = weight_index(8, seen << 8 | recency);
+}
+
+float LearnedAdmission::predict(const uint32_t* features) const {
+    float z = 0;
+    for (unsigned int i = 0; i < LEARNED_ADMISSION_FEATURES; i++) {
+        z += weights[features[i]];
+    }
+    return 1 / (1 + exp(-z));
+}
+
+void LearnedAdmission::learn(LearnedAdmissionEntry& entry, bool positive) {
+    entry.pending = false;
+
+    float p = predict(entry.features);
+    float gradient = (positive ? 1 : 0) - p;
+    for (unsigned int i = 0; i < LEARNED_ADMISSION_FEATURES; i++) {
+        weights[entry.features[i]] += LEARNED_ADMISSION_RATE * gradient;
+    }
+    loss -= log(max(positive ? p : 1 - p, 1e-6f));
+    labels++;
+
+    if (entry.admitted) {
+        if (positive) {
+            admitted_hit++;
+        } else {
+            admitted_wasted++;
+        }
+    }
+    else {
+        if (positive) {
+            rejected_back++;
+        } else {
+            rejected_gone++;
+        }
+    }
+}
+
+void LearnedAdmission::note(LearnedAdmissionEntry& entry, uint64_t fp) {
+    entry.count++;
+    entry.last_request = now;
+    entry.events++;
+    LearnedAdmissionEvent event;
+    event.fingerprint = fp;
+    event.time = now;
+    window.push_back(event);
+    now++;
+
+    // Deadlines are nearly in order, one a little late waits for those before it
+    while (!decisions.empty() && decisions.front().time < now) {
+        LearnedAdmissionEvent old = decisions.pop_front();
+        unordered_map<uint64_t, LearnedAdmissionEntry>::iterator it = keys.find(old.fingerprint);
+        if (it != keys.end() && it->second.pending && it->second.deadline == old.time) {
+            // Nothing since, an admitted one was never hit
+            learn(it->second, false);
+        }
+    }
+
+    while (!window.empty() && window.front().time + LEARNED_ADMISSION_MEMORY * horizon < now) {
+        LearnedAdmissionEvent old = window.pop_front();
+        unordered_map<uint64_t, LearnedAdmissionEntry>::iterator it = keys.find(old.fingerprint);
+        if (--it->second.events == 0) {
+            keys.erase(it);
+        }
+    }
+}
+
+// Should we let this in?
+bool LearnedAdmission::check(string key, unsigned long data, unsigned long long size,
+                             unsigned long ts, string customer_id_str) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    uint64_t fp = fingerprint(key);
+    LearnedAdmissionEntry& entry = keys[fp]; // zeroed if new
+
+    // Missed again: evicted before any hit, or rejected and back
+    if (entry.pending) {
+        learn(entry, !entry.admitted);
+    }
+
+    featurize(entry, size, key, customer_id_str, entry.features);
+    bool admit;
+    if (check_customer_in_list(customer_id_str)) {
+        // This customer bypasses the filter, just let it in
+        admit = true;
+    }
+    else if (labels < LEARNED_ADMISSION_WARMUP) {
+        admit = entry.count > 0;
+    }
+    else {
+        admit = predict(entry.features) >= threshold;
+    }
+
+    entry.pending = true;
+    entry.admitted = admit;
+    entry.deadline = now + (unsigned long long) horizon;
+    LearnedAdmissionEvent decision;
+    decision.fingerprint = fp;
+    decision.time = entry.deadline;
+    decisions.push_back(decision);
+    note(entry, fp);
+
+    if (admit) {
+        admitted++;
+    } else {
+        rejected++;
+    }
+    check_ns += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    return admit;
+}
+
+void LearnedAdmission::record_hit(const string& key, unsigned long long size,
+                                  unsigned long ts, const string& customer_id_str) {
+    uint64_t fp = fingerprint(key);
+    LearnedAdmissionEntry& entry = keys[fp];
+    if (entry.pending && entry.admitted) {
+        learn(entry, true);
+    }
+    // Hits this far apart still make it, the horizon fades towards the recent ones
+    if (auto_horizon && entry.count > 0) {
+        double gap = now - entry.last_request;
+        horizon = max(gap, horizon * (1 - 1.0 / LEARNED_ADMISSION_HORIZON_DECAY));
+        horizon = max(horizon, (double) LEARNED_ADMISSION_MIN_HORIZON);
+    }
+    note(entry, fp);
+}
+
+bool LearnedAdmission::check_customer_in_list(string custid) const{
+    if(std::find(no_bf_cust.begin(), no_bf_cust.end(), custid) != no_bf_cust.end())
+        return true;
+    else
+        return false;
+}
+
+void LearnedAdmission::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    unsigned long settled = admitted_hit + admitted_wasted + rejected_back + rejected_gone;
+    outlogfile << admitted << " "
+        << rejected << " "
+        << admitted_hit << " "
+        << admitted_wasted << " "
+        << rejected_back << " "
+        << rejected_gone << " "
+        << (settled > 0 ? loss / settled : 0) << " "
+        << keys.size() << " "
+        << (unsigned long long) horizon << " "
+        << check_ns << " ";
+
+    admitted = 0;
+    rejected = 0;
+    admitted_hit = 0;
+    admitted_wasted = 0;
+    rejected_back = 0;
+    rejected_gone = 0;
+    loss = 0;
+    check_ns = 0;
+}
@@ -0,0 +1,260 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Least Hit Density eviction: learned per class hit densities, sampled victims
+ *
+ */
+
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "lhd_eviction.h"
+
+using namespace std;
+
+LHDEviction::LHDEviction(unsigned long long size, string id, const EmConfItems * sci) {
+    name = "lhd";
+    this->sci = sci;
+
+    total_capacity = size;
+    cache_id = id;
+    current_size = 0;
+
+    sample_count = sci->eviction_samples;
+    now = 0;
+    age_shift = 0;
+    overflows = 0;
+    events = 0;
+
+    // Until the first reconfigure, younger is denser (LRU within a class)
+    classes.resize(LHD_CLASSES);
+    for (size_t c = 0; c < classes.size(); c++) {
+        classes[c].hits.assign(LHD_MAX_AGE, 0);
+        classes[c].evictions.assign(LHD_MAX_AGE, 0);
+        classes[c].density.resize(LHD_MAX_AGE);
+        for (size_t a = 0; a < LHD_MAX_AGE; a++) {
+            classes[c].density[a] = 1. / (a + 1);
+        }
+    }
+
+    evicted = 0;
+    evicted_bytes = 0;
+    evicted_density_sum = 0;
+    reconfigurations = 0;
+}
+
+LHDEviction::~LHDEviction()
+{
+    for (size_t i = 0; i < entries.size(); i++) {
+        delete entries[i];
+    }
+}
+
+unsigned int LHDEviction::class_of(const LHDEvictionEntry* node) const {
+    unsigned int ref = 0;
+    for (unsigned long c = node->count; c > 1 && ref < LHD_REF_CLASSES - 1; c >>= 1) {
+        ref++;
+    }
+    int size_log2 = 0;
+    for (unsigned long s = node->data; s > 1; s >>= 1) {
+        size_log2++;
+    }
+    int size_class = (size_log2 - LHD_MIN_SIZE_LOG2) / 2;
+    if (size_class < 0) {
+        size_class = 0;
+    } else if (size_class > LHD_SIZE_CLASSES - 1) {
+        size_class = LHD_SIZE_CLASSES - 1;
+    }
+    return ref * LHD_SIZE_CLASSES + size_class;
+}
+
+unsigned int LHDEviction::age_of(const LHDEvictionEntry* node) {
+    unsigned long long age = (now - node->last_access) >> age_shift;
+    if (age >= LHD_MAX_AGE - 1) {
+        return LHD_MAX_AGE - 1;
+    }
+    return age;
+}
+
+double LHDEviction::density_of(const LHDEvictionEntry* node) {
+    return classes[class_of(node)].density[age_of(node)] / (node->data ? node->data : 1);
+}
+
+void LHDEviction::hourly_purging(unsigned long timestamp) {
+    reconfigure();
+}
+
+/*
+ * An entry of age a in a class will be hit with probability (hits at ages
+ * >= a) / (events at ages >= a) and stay on average (sum over ages >= a of
+ * events at or after that age) / (events at ages >= a) more buckets, their
+ * ratio is its hit density.
+ */
+void LHDEviction::reconfigure() {
+    if (events > 0 && overflows > LHD_MAX_OVERFLOW * events) {
+        coarsen_ages();
+    }
+
+    for (size_t c = 0; c < classes.size(); c++) {
+        LHDClass& cls = classes[c];
+        double hits = 0;
+        double all = 0;
+        double lifetime = 0;
+        for (int a = LHD_MAX_AGE - 1; a >= 0; a--) {
+            hits += cls.hits[a];
+            all += cls.hits[a] + cls.evictions[a];
+            lifetime += all;
+            cls.density[a] = lifetime > 0 ? hits / lifetime : 0;
+        }
+
+        for (size_t a = 0; a < LHD_MAX_AGE; a++) {
+            cls.hits[a] *= LHD_EWMA_DECAY;
+            cls.evictions[a] *= LHD_EWMA_DECAY;
+        }
+    }
+
+    overflows = 0;
+    events = 0;
+    reconfigurations++;
+}
+
+/* Too many events past the last bucket, make the buckets twice as wide */
+void LHDEviction::coarsen_ages() {
+    age_shift++;
+    for (size_t c = 0; c < classes.size(); c++) {
+        LHDClass& cls = classes[c];
+        for (size_t a = 0; a < LHD_MAX_AGE / 2; a++) {
+            cls.hits[a] = cls.hits[2 * a] + cls.hits[2 * a + 1];
+            cls.evictions[a] = cls.evictions[2 * a] + cls.evictions[2 * a + 1];
+        }
+        for (size_t a = LHD_MAX_AGE / 2; a < LHD_MAX_AGE; a++) {
+            cls.hits[a] = 0;
+            cls.evictions[a] = 0;
+        }
+    }
+}
+
+unsigned long long LHDEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    LHDEvictionEntry* node = new LHDEvictionEntry;
+    node->key = key;
+    node->customer_id = customer_id;
+    node->data = data;
+    node->timestamp = timestamp;
+    node->count = 1;
+    node->last_access = ++now;
+    node->slot = entries.size();
+    entries.push_back(node);
+    _mapping[key] = node;
+    current_size += data;
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity) {
+        purge_regular();
+    }
+    return current_size;
+}
+
+unsigned long LHDEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, LHDEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    // The hit counts for the class and age the entry had until now
+    LHDEvictionEntry* node = it->second;
+    unsigned int age = age_of(node);
+    classes[class_of(node)].hits[age] += 1;
+    events++;
+    if (age == LHD_MAX_AGE - 1) {
+        overflows++;
+    }
+
+    node->count++;
+    node->timestamp = ts;
+    node->last_access = ++now;
+    return node->data;
+}
+
+int LHDEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    return _mapping.find(key) != _mapping.end();
+}
+
+bool LHDEviction::purge_regular() {
+    if (entries.empty()) {
+        return false;
+    }
+
+    LHDEvictionEntry* victim = NULL;
+    double victim_density = 0;
+    unsigned int samples = entries.size() < sample_count ? entries.size() : sample_count;
+    for (unsigned int i = 0; i < samples; i++) {
+        // Small cache, just look at everything
+        LHDEvictionEntry* node = entries.size() <= sample_count ? entries[i] : entries[rng.below(entries.size())];
+        double d = density_of(node);
+        if (victim == NULL || d < victim_density) {
+            victim = node;
+            victim_density = d;
+        }
+    }
+
+    unsigned int age = age_of(victim);
+    classes[class_of(victim)].evictions[age] += 1;
+    events++;
+    if (age == LHD_MAX_AGE - 1) {
+        overflows++;
+    }
+
+    evicted++;
+    evicted_bytes += victim->data;
+    evicted_density_sum += victim_density;
+    evict(victim);
+    return true;
+}
+
+/* Swap with the last slot and pop, keeps the array dense */
+void LHDEviction::evict(LHDEvictionEntry* node) {
+    LHDEvictionEntry* last = entries.back();
+    entries[node->slot] = last;
+    last->slot = node->slot;
+    entries.pop_back();
+
+    current_size -= node->data;
+    _mapping.erase(node->key);
+    delete node;
+}
+
+unsigned long long LHDEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long LHDEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void LHDEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << _mapping.size() << " "
+        << sample_count << " "
+        << age_shift << " "
+        << reconfigurations << " "
+        << evicted << " "
+        << evicted_bytes << " "
+        << (evicted ? evicted_density_sum / evicted : 0) << " ";
+
+    evicted = 0;
+    evicted_bytes = 0;
+    evicted_density_sum = 0;
+    reconfigurations = 0;
+}
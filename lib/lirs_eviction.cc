@@ -0,0 +1,325 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * LIRS: LIR/HIR split by reuse distance
+ *
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "lirs_eviction.h"
+
+using namespace std;
+
+LIRSEviction::LIRSEviction(unsigned long long size, string id, const EmConfItems * sci) {
+    name = "lirs";
+    this->sci = sci;
+
+    // Both parts need room, and a share above 1 can't become a capacity
+    if (!(sci->lirs_hir_share > 0 && sci->lirs_hir_share < 1)) {
+        cerr << "\nlirs_hir_share must be between 0 and 1, got " << sci->lirs_hir_share << ". Exiting.\n";
+        exit(1);
+    }
+
+    total_capacity = size;
+    lir_capacity = size * (1 - sci->lirs_hir_share);
+    cache_id = id;
+    current_size = 0;
+
+    s_top = new LIRSEvictionEntry;
+    s_bottom = new LIRSEvictionEntry;
+    s_top->s_prev = NULL;
+    s_top->s_next = s_bottom;
+    s_bottom->s_prev = s_top;
+    s_bottom->s_next = NULL;
+    q_head = new LIRSEvictionEntry;
+    q_tail = new LIRSEvictionEntry;
+    q_head->q_prev = NULL;
+    q_head->q_next = q_tail;
+    q_tail->q_prev = q_head;
+    q_tail->q_next = NULL;
+    nr_head = new LIRSEvictionEntry;
+    nr_tail = new LIRSEvictionEntry;
+    nr_head->q_prev = NULL;
+    nr_head->q_next = nr_tail;
+    nr_tail->q_prev = nr_head;
+    nr_tail->q_next = NULL;
+
+    lir_bytes = 0;
+    hir_bytes = 0;
+    lir_items = 0;
+    hir_items = 0;
+    nonresident_items = 0;
+    stack_items = 0;
+
+    lir_hits = 0;
+    hir_hits = 0;
+    nonresident_hits = 0;
+    demoted = 0;
+    evicted = 0;
+}
+
+LIRSEviction::~LIRSEviction()
+{
+    for (unordered_map<string, LIRSEvictionEntry*>::iterator it = _mapping.begin(); it != _mapping.end(); ++it) {
+        delete it->second;
+    }
+    delete s_top;
+    delete s_bottom;
+    delete q_head;
+    delete q_tail;
+    delete nr_head;
+    delete nr_tail;
+}
+
+void LIRSEviction::stack_push_top(LIRSEvictionEntry* node) {
+    if (node->in_stack) {
+        stack_remove(node);
+    }
+    node->s_next = s_top->s_next;
+    node->s_prev = s_top;
+    node->s_next->s_prev = node;
+    s_top->s_next = node;
+    node->in_stack = true;
+    stack_items++;
+}
+
+void LIRSEviction::stack_remove(LIRSEvictionEntry* node) {
+    node->s_prev->s_next = node->s_next;
+    node->s_next->s_prev = node->s_prev;
+    node->in_stack = false;
+    stack_items--;
+}
+
+void LIRSEviction::list_push_back(LIRSEvictionEntry* node, LIRSEvictionEntry* tail) {
+    node->q_prev = tail->q_prev;
+    node->q_next = tail;
+    node->q_prev->q_next = node;
+    tail->q_prev = node;
+}
+
+void LIRSEviction::list_remove(LIRSEvictionEntry* node) {
+    node->q_prev->q_next = node->q_next;
+    node->q_next->q_prev = node->q_prev;
+}
+
+void LIRSEviction::prune() {
+    while (s_bottom->s_prev != s_top && s_bottom->s_prev->state != LIRS_LIR) {
+        LIRSEvictionEntry* node = s_bottom->s_prev;
+        stack_remove(node);
+        if (node->state == LIRS_NONRESIDENT) {
+            forget(node);
+        }
+    }
+}
+
+void LIRSEviction::demote_bottom() {
+    LIRSEvictionEntry* node = s_bottom->s_prev;
+    if (node == s_top) {
+        return;
+    }
+    assert(node->state == LIRS_LIR);
+
+    node->state = LIRS_HIR;
+    lir_bytes -= node->data;
+    lir_items--;
+    hir_bytes += node->data;
+    hir_items++;
+    stack_remove(node);
+    list_push_back(node, q_tail);
+    demoted++;
+    prune();
+}
+
+void LIRSEviction::make_lir(LIRSEvictionEntry* node) {
+    node->state = LIRS_LIR;
+    lir_bytes += node->data;
+    lir_items++;
+    stack_push_top(node);
+
+    // The newcomer is on top, so never the one demoted
+    while (lir_bytes > lir_capacity && lir_items > 1) {
+        demote_bottom();
+    }
+}
+
+/* Drops a non resident entry altogether */
+void LIRSEviction::forget(LIRSEvictionEntry* node) {
+    list_remove(node);
+    nonresident_items--;
+    _mapping.erase(node->key);
+    delete node;
+}
+
+void LIRSEviction::trim_nonresident() {
+    while (nonresident_items > LIRS_NONRESIDENT_FACTOR * (lir_items + hir_items)) {
+        LIRSEvictionEntry* node = nr_head->q_next;
+        stack_remove(node);
+        forget(node);
+    }
+}
+
+void LIRSEviction::hourly_purging(unsigned long timestamp) {
+    while (current_size > total_capacity * .80) {
+        purge_regular();
+    }
+}
+
+unsigned long long LIRSEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(check(key, timestamp) == 0); // we always 'check' before we 'put'.
+
+    // Make room first, pruning may forget this key's non resident entry
+    while (current_size + data > total_capacity && purge_regular()) {
+    }
+
+    unordered_map<string, LIRSEvictionEntry*>::iterator it = _mapping.find(key);
+    if (it != _mapping.end()) {
+        // Back while still in S: shorter reuse distance than the bottom LIR
+        LIRSEvictionEntry* node = it->second;
+        list_remove(node);
+        nonresident_items--;
+        nonresident_hits++;
+        node->data = data;
+        node->timestamp = timestamp;
+        node->count++;
+        current_size += data;
+        make_lir(node);
+    }
+    else {
+        LIRSEvictionEntry* node = new LIRSEvictionEntry;
+        node->key = key;
+        node->customer_id = customer_id;
+        node->data = data;
+        node->timestamp = timestamp;
+        node->count = 1;
+        node->in_stack = false;
+        _mapping[key] = node;
+        current_size += data;
+
+        if (lir_bytes + data <= lir_capacity) {
+            // Still warming up
+            make_lir(node);
+        }
+        else {
+            node->state = LIRS_HIR;
+            hir_bytes += data;
+            hir_items++;
+            stack_push_top(node);
+            list_push_back(node, q_tail);
+        }
+    }
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity && purge_regular()) {
+    }
+    trim_nonresident();
+    return current_size;
+}
+
+unsigned long LIRSEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, LIRSEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end() && it->second->state != LIRS_NONRESIDENT); // we always 'check' before we 'get'.
+
+    LIRSEvictionEntry* node = it->second;
+    if (node->state == LIRS_LIR) {
+        lir_hits++;
+        bool was_bottom = (s_bottom->s_prev == node);
+        stack_push_top(node);
+        if (was_bottom) {
+            prune();
+        }
+    }
+    else if (node->in_stack) {
+        hir_hits++;
+        list_remove(node);
+        hir_bytes -= node->data;
+        hir_items--;
+        make_lir(node);
+    }
+    else {
+        // Reuse distance still too long, stays HIR
+        hir_hits++;
+        stack_push_top(node);
+        list_remove(node);
+        list_push_back(node, q_tail);
+    }
+
+    node->count++;
+    node->timestamp = ts;
+    return node->data;
+}
+
+int LIRSEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    unordered_map<string, LIRSEvictionEntry*>::iterator it = _mapping.find(key);
+    return it != _mapping.end() && it->second->state != LIRS_NONRESIDENT;
+}
+
+bool LIRSEviction::purge_regular() {
+    if (q_head->q_next == q_tail) {
+        if (lir_items == 0) {
+            return false;
+        }
+        demote_bottom();
+    }
+
+    LIRSEvictionEntry* node = q_head->q_next;
+    list_remove(node);
+    hir_bytes -= node->data;
+    hir_items--;
+    current_size -= node->data;
+    evicted++;
+
+    if (node->in_stack) {
+        // Remember it for as long as it is in S
+        node->state = LIRS_NONRESIDENT;
+        list_push_back(node, nr_tail);
+        nonresident_items++;
+    }
+    else {
+        _mapping.erase(node->key);
+        delete node;
+    }
+    return true;
+}
+
+unsigned long long LIRSEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long LIRSEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void LIRSEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << lir_bytes << " "
+        << hir_bytes << " "
+        << lir_items << " "
+        << hir_items << " "
+        << nonresident_items << " "
+        << stack_items << " "
+        << lir_hits << " "
+        << hir_hits << " "
+        << nonresident_hits << " "
+        << demoted << " "
+        << evicted << " ";
+
+    lir_hits = 0;
+    hir_hits = 0;
+    nonresident_hits = 0;
+    demoted = 0;
+    evicted = 0;
+}
@@ -0,0 +1,317 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Learned eviction: sampled candidates ranked by a boosted tree model
+ *
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "hashfunc.h"
+#include "content_class.h"
+#include "lrb_eviction.h"
+
+using namespace std;
+
+/* Runs on the training thread */
+static void lrb_train(LRBTraining* job) {
+    GBTParams params;
+    params.trees = LRB_TREES;
+    params.depth = LRB_DEPTH;
+    params.min_leaf = LRB_MIN_LEAF;
+    params.learning_rate = LRB_LEARNING_RATE;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    job->rmse = job->model.train(job->x, job->y, LRB_FEATURES, params);
+    job->train_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+LRBEviction::LRBEviction(unsigned long long size, string id, const EmConfItems * sci) {
+    name = "lrb";
+    this->sci = sci;
+
+    total_capacity = size;
+    cache_id = id;
+    current_size = 0;
+    now = 0;
+    window_size = sci->lrb_window > 0 ? sci->lrb_window : 1;
+    sample_count = sci->eviction_samples;
+    training = NULL;
+
+    evicted = 0;
+    features = 0;
+    feature_ns = 0;
+    inferences = 0;
+    inference_ns = 0;
+    trainings = 0;
+    train_ms = 0;
+    train_rmse = 0;
+}
+
+LRBEviction::~LRBEviction()
+{
+    if (training != NULL) {
+        trainer.join();
+        delete training;
+    }
+    for (unordered_map<string, LRBEvictionEntry*>::iterator it = _mapping.begin(); it != _mapping.end(); ++it) {
+        delete it->second;
+    }
+}
+
+void LRBEviction::extract(const LRBEvictionEntry* node, float* row) {
+    row[0] = now - node->last_access;
+    unsigned long known = node->count - 1; // gaps between its requests
+    for (unsigned int i = 0; i < LRB_DELTAS; i++) {
+        row[1 + i] = i < known ? (float) node->deltas[i] : -1;
+    }
+    row[LRB_DELTAS + 1] = node->data;
+    row[LRB_DELTAS + 2] = node->customer;
+    row[LRB_DELTAS + 3] = node->extension;
+}
+
+void LRBEviction::hourly_purging(unsigned long timestamp) {
+    while (current_size > total_capacity * .80) {
+        purge_regular();
+    }
+}
+
+void LRBEviction::touch(LRBEvictionEntry* node) {
+    now++;
+    if (node->pending) {
+        label(node, now - node->sample_time);
+    }
+    if (node->count > 0) {
+        memmove(node->deltas + 1, node->deltas, (LRB_DELTAS - 1) * sizeof(node->deltas[0]));
+        unsigned long long gap = now - node->last_access;
+        node->deltas[0] = gap > 0xffffffffULL ? 0xffffffffU : gap;
+    }
+    node->count++;
+    node->last_access = now;
+
+    LRBWindowEvent event;
+    event.node = node;
+    event.time = now;
+    event.sample = false;
+    window.push_back(event);
+    node->events++;
+
+    sample_one();
+    expire();
+}
+
+void LRBEviction::label(LRBEvictionEntry* node, unsigned long long distance) {
+    node->pending = false;
+    batch_x.insert(batch_x.end(), node->sample, node->sample + LRB_FEATURES);
+    batch_y.push_back(log2(1.0 + distance));
+    if (batch_y.size() >= LRB_TRAIN_SAMPLES) {
+        submit();
+    }
+}
+
+void LRBEviction::sample_one() {
+    if (entries.empty()) {
+        return;
+    }
+    LRBEvictionEntry* node = entries[rng.below(entries.size())];
+    if (node->pending) {
+        return;
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    extract(node, node->sample);
+    feature_ns += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    features++;
+
+    node->pending = true;
+    node->sample_time = now;
+    LRBWindowEvent event;
+    event.node = node;
+    event.time = now;
+    event.sample = true;
+    window.push_back(event);
+    node->events++;
+}
+
+void LRBEviction::expire() {
+    while (!window.empty() && window.front().time + window_size < now) {
+        LRBWindowEvent event = window.pop_front();
+        LRBEvictionEntry* node = event.node;
+        node->events--;
+        if (event.sample && node->pending && node->sample_time == event.time) {
+            // Not back within the window
+            label(node, 2 * window_size);
+        }
+        if (!node->cached && node->events == 0) {
+            _mapping.erase(node->key);
+            delete node;
+        }
+    }
+}
+
+void LRBEviction::submit() {
+    if (training != NULL) {
+        trainer.join();
+        model = training->model;
+        trainings++;
+        train_ms += training->train_ms;
+        train_rmse = training->rmse;
+        delete training;
+    }
+
+    training = new LRBTraining;
+    training->x.swap(batch_x);
+    training->y.swap(batch_y);
+    trainer = thread(lrb_train, training);
+}
+
+unsigned long long LRBEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(check(key, timestamp) == 0); // we always 'check' before we 'put'.
+
+    while (current_size + data > total_capacity && purge_regular()) {
+    }
+
+    LRBEvictionEntry* node;
+    unordered_map<string, LRBEvictionEntry*>::iterator it = _mapping.find(key);
+    if (it != _mapping.end()) {
+        // Evicted but still in the window, its history carries on
+        node = it->second;
+    }
+    else {
+        node = new LRBEvictionEntry;
+        node->key = key;
+        node->count = 0;
+        node->last_access = 0;
+        node->customer = wyhash(customer_id.data(), customer_id.size(), LRB_HASH_SEED) & 0xffff;
+        node->extension = content_class(key);
+        node->events = 0;
+        node->pending = false;
+        node->sample_time = 0;
+        _mapping[key] = node;
+    }
+    node->customer_id = customer_id;
+    node->data = data;
+    node->timestamp = timestamp;
+    node->cached = true;
+    node->slot = entries.size();
+    entries.push_back(node);
+    current_size += data;
+
+    touch(node);
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity && purge_regular()) {
+    }
+    return current_size;
+}
+
+unsigned long LRBEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, LRBEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end() && it->second->cached); // we always 'check' before we 'get'.
+
+    LRBEvictionEntry* node = it->second;
+    node->timestamp = ts;
+    touch(node);
+    return node->data;
+}
+
+int LRBEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    unordered_map<string, LRBEvictionEntry*>::iterator it = _mapping.find(key);
+    return it != _mapping.end() && it->second->cached;
+}
+
+bool LRBEviction::purge_regular() {
+    if (entries.empty()) {
+        return false;
+    }
+
+    unsigned int samples = entries.size() < sample_count ? entries.size() : sample_count;
+    LRBEvictionEntry* victim = NULL;
+    float worst = 0;
+    float row[LRB_FEATURES];
+    for (unsigned int i = 0; i < samples; i++) {
+        LRBEvictionEntry* node = entries[rng.below(entries.size())];
+        float score;
+        if (model.empty()) {
+            score = now - node->last_access;
+        }
+        else {
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            extract(node, row);
+            chrono::steady_clock::time_point extracted = chrono::steady_clock::now();
+            score = model.predict(row);
+            chrono::steady_clock::time_point predicted = chrono::steady_clock::now();
+            feature_ns += chrono::duration_cast<chrono::nanoseconds>(extracted - start).count();
+            inference_ns += chrono::duration_cast<chrono::nanoseconds>(predicted - extracted).count();
+            features++;
+            inferences++;
+        }
+        if (victim == NULL || score > worst) {
+            worst = score;
+            victim = node;
+        }
+    }
+
+    entries[victim->slot] = entries.back();
+    entries[victim->slot]->slot = victim->slot;
+    entries.pop_back();
+    victim->cached = false;
+    current_size -= victim->data;
+    evicted++;
+
+    // Kept while the window still has its requests or sample
+    if (victim->events == 0) {
+        _mapping.erase(victim->key);
+        delete victim;
+    }
+    return true;
+}
+
+unsigned long long LRBEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long LRBEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void LRBEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << entries.size() << " "
+        << _mapping.size() << " "
+        << evicted << " "
+        << features << " "
+        << feature_ns << " "
+        << inferences << " "
+        << inference_ns << " "
+        << trainings << " "
+        << train_ms << " "
+        << train_rmse << " "
+        << model.get_trees() << " "
+        << batch_y.size() << " ";
+
+    evicted = 0;
+    features = 0;
+    feature_ns = 0;
+    inferences = 0;
+    inference_ns = 0;
+    trainings = 0;
+    train_ms = 0;
+}
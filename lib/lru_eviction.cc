@@ -310,6 +310,21 @@ bool LRUEviction::purge_regular() {
     return true;
 }
 
+/* The least recently requested first, as many as putting incoming would evict */
+bool LRUEviction::peek_victims(unsigned long long incoming, size_t max_victims,
+                               vector<pair<string, unsigned long> >& victims) {
+    victims.clear();
+    unsigned long long freed = 0;
+    for (LRUEvictionEntry* node = tail->prev;
+         node != head && current_size + incoming - freed > total_capacity
+         && victims.size() < max_victims;
+         node = node->prev) {
+        victims.push_back(make_pair(node->key, node->data));
+        freed += node->data;
+    }
+    return true;
+}
+
 unsigned long long LRUEviction::get_size() {
     return current_size;
 }
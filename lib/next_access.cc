@@ -0,0 +1,170 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Next access annotation: reverse pass over the trace, spilled in chunks
+ *
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "status.h"
+#include "hashfunc.h"
+#include "emulator.h"
+#include "next_access.h"
+
+using namespace std;
+
+NextAccessOracle::NextAccessOracle() {
+    const char* tmpdir = getenv("TMPDIR");
+    spill_dir = (tmpdir != NULL && tmpdir[0] != '\0') ? tmpdir : "/tmp";
+
+    keys = NULL;
+    nexts = NULL;
+    requests = 0;
+    served = 0;
+}
+
+NextAccessOracle::~NextAccessOracle()
+{
+    if (keys != NULL) {
+        fclose(keys);
+    }
+    if (nexts != NULL) {
+        fclose(nexts);
+    }
+}
+
+FILE* NextAccessOracle::open_spill(string& path) {
+    path = spill_dir + "/next_access.XXXXXX";
+    vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+
+    int fd = mkstemp(&name[0]);
+    FILE* f = fd < 0 ? NULL : fdopen(fd, "w+b");
+    if (f == NULL) {
+        cerr << "\nCan't create a spill file in " << spill_dir << ". Exiting.\n";
+        exit(1);
+    }
+    path = &name[0];
+    return f;
+}
+
+void NextAccessOracle::read_records(FILE* f, unsigned long long first, vector<uint64_t>& records) {
+    records.resize(NEXT_ACCESS_CHUNK);
+    size_t n = 0;
+    if (fseeko(f, first * sizeof(uint64_t), SEEK_SET) == 0) {
+        n = fread(&records[0], sizeof(uint64_t), records.size(), f);
+    }
+    if (n == 0) {
+        cerr << "\nCan't read back the next access spill file. Exiting.\n";
+        exit(1);
+    }
+    records.resize(n);
+}
+
+void NextAccessOracle::write_records(FILE* f, unsigned long long first, const vector<uint64_t>& records) {
+    if (fseeko(f, first * sizeof(uint64_t), SEEK_SET) != 0
+            || fwrite(&records[0], sizeof(uint64_t), records.size(), f) != records.size()) {
+        cerr << "\nCan't write the next access spill file in " << spill_dir << ". Exiting.\n";
+        exit(1);
+    }
+}
+
+void NextAccessOracle::annotate(istream& in, Emulator* em) {
+    string trace_path;
+    string path;
+    FILE* trace_out = open_spill(trace_path);
+    keys = open_spill(path);
+    unlink(path.c_str());
+
+    em->output << "\nAnnotating next accesses...";
+
+    // Forward: copy the trace, keep the fingerprints of what gets processed
+    vector<uint64_t> chunk;
+    item_packet ip_inst;
+    string curr_line;
+    requests = 0;
+    while (getline(in, curr_line)) {
+        fputs(curr_line.c_str(), trace_out);
+        fputc('\n', trace_out);
+
+        if (em->parse_access_log_line(curr_line, ip_inst) != 3) {
+            continue;
+        }
+        // Only full chunks go to disk, the last one stays here
+        if (chunk.size() == NEXT_ACCESS_CHUNK) {
+            write_records(keys, requests - chunk.size(), chunk);
+            chunk.clear();
+        }
+        chunk.push_back(wyhash(ip_inst.city64_str.data(), ip_inst.city64_str.size(), NEXT_ACCESS_HASH_SEED));
+        requests++;
+    }
+
+    if (fclose(trace_out) != 0) {
+        cerr << "\nCan't write the trace spill file in " << spill_dir << ". Exiting.\n";
+        exit(1);
+    }
+    trace_in.open(trace_path.c_str());
+    unlink(trace_path.c_str());
+
+    // Backward, one chunk at a time, last one first
+    unsigned long long last_first = requests - chunk.size();
+    if (last_first > 0) {
+        nexts = open_spill(path);
+        unlink(path.c_str());
+    }
+    unordered_map<uint64_t, unsigned long long> seen; // fingerprint to its earliest request so far
+    for (unsigned long long first = last_first + NEXT_ACCESS_CHUNK; first > 0;) {
+        first -= NEXT_ACCESS_CHUNK;
+        if (first != last_first) {
+            read_records(keys, first, chunk);
+        }
+        next_chunk.resize(chunk.size());
+        for (size_t i = chunk.size(); i-- > 0;) {
+            unordered_map<uint64_t, unsigned long long>::iterator it = seen.find(chunk[i]);
+            if (it == seen.end()) {
+                next_chunk[i] = NEXT_ACCESS_NEVER;
+                seen[chunk[i]] = first + i;
+            }
+            else {
+                next_chunk[i] = it->second;
+                it->second = first + i;
+            }
+        }
+        if (nexts != NULL) {
+            write_records(nexts, first, next_chunk);
+        }
+    }
+    // next_chunk is left holding the first chunk
+
+    fclose(keys);
+    keys = NULL;
+
+    em->output << "\n" << requests << " requests, " << seen.size() << " keys, "
+        << (nexts != NULL ? "spilled" : "in memory") << endl;
+}
+
+istream& NextAccessOracle::trace() {
+    return trace_in;
+}
+
+void NextAccessOracle::next(unsigned long long& request, unsigned long long& next_access) {
+    assert(served < requests); // the replay parses lines the same way
+
+    size_t pos = served % NEXT_ACCESS_CHUNK;
+    if (pos == 0 && served > 0) {
+        read_records(nexts, served, next_chunk);
+    }
+    request = served++;
+    next_access = next_chunk[pos];
+}
@@ -0,0 +1,233 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * S3-FIFO: small, main and ghost FIFO queues
+ *
+ */
+
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "s3fifo_eviction.h"
+
+using namespace std;
+
+S3FIFOEviction::S3FIFOEviction(unsigned long long size, string id, const EmConfItems * sci) {
+    name = "s3fifo";
+    this->sci = sci;
+
+    total_capacity = size;
+    small_capacity = size * S3FIFO_SMALL_SHARE;
+    cache_id = id;
+    current_size = 0;
+    small_bytes = 0;
+    main_bytes = 0;
+    ghost_seq = 0;
+
+    small_hits = 0;
+    main_hits = 0;
+    promoted = 0;
+    reinserted = 0;
+    ghost_hits = 0;
+    evicted_small = 0;
+    evicted_main = 0;
+}
+
+S3FIFOEviction::~S3FIFOEviction()
+{
+    while (!small.empty()) {
+        delete small.pop_front();
+    }
+    while (!main.empty()) {
+        delete main.pop_front();
+    }
+}
+
+void S3FIFOEviction::hourly_purging(unsigned long timestamp) {
+    while (current_size > total_capacity * .80) {
+        purge_regular();
+    }
+}
+
+/* Keeps about as many ghosts as there are cached objects */
+void S3FIFOEviction::remember_ghost(uint64_t hash) {
+    S3FIFOGhost g;
+    g.hash = hash;
+    g.seq = ++ghost_seq;
+    ghost.push_back(g);
+    ghost_index[hash] = g.seq;
+
+    size_t limit = small.size() + main.size() + 1;
+    while (ghost.size() > limit) {
+        S3FIFOGhost old = ghost.pop_front();
+        unordered_map<uint64_t, unsigned long long>::iterator it = ghost_index.find(old.hash);
+        if (it != ghost_index.end() && it->second == old.seq) {
+            ghost_index.erase(it);
+        }
+    }
+}
+
+/* True if hash was a ghost, which it no longer is */
+bool S3FIFOEviction::take_ghost(uint64_t hash) {
+    unordered_map<uint64_t, unsigned long long>::iterator it = ghost_index.find(hash);
+    if (it == ghost_index.end()) {
+        return false;
+    }
+    ghost_index.erase(it);
+    return true;
+}
+
+unsigned long long S3FIFOEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    S3FIFOEvictionEntry* node = new S3FIFOEvictionEntry;
+    node->key = key;
+    node->customer_id = customer_id;
+    node->data = data;
+    node->timestamp = timestamp;
+    node->count = 1;
+    node->freq = 0;
+    _mapping[key] = node;
+    current_size += data;
+
+    // Evicted from small not long ago, it has proven itself
+    if (take_ghost(key_hash(key))) {
+        ghost_hits++;
+        node->in_main = true;
+        main.push_back(node);
+        main_bytes += data;
+    }
+    else {
+        node->in_main = false;
+        small.push_back(node);
+        small_bytes += data;
+    }
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity) {
+        purge_regular();
+    }
+    return current_size;
+}
+
+unsigned long S3FIFOEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, S3FIFOEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    // No queue moves on a hit
+    S3FIFOEvictionEntry* node = it->second;
+    if (node->freq < S3FIFO_MAX_FREQ) {
+        node->freq++;
+    }
+    node->count++;
+    node->timestamp = ts;
+    if (node->in_main) {
+        main_hits++;
+    } else {
+        small_hits++;
+    }
+    return node->data;
+}
+
+int S3FIFOEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    return _mapping.find(key) != _mapping.end();
+}
+
+bool S3FIFOEviction::purge_regular() {
+    if (small.empty() && main.empty()) {
+        return false;
+    }
+    if (!small.empty() && (small_bytes > small_capacity || main.empty())) {
+        evict_small();
+    }
+    else {
+        evict_main();
+    }
+    return true;
+}
+
+/* Moves hit entries on to main until one can be evicted */
+void S3FIFOEviction::evict_small() {
+    while (!small.empty()) {
+        S3FIFOEvictionEntry* node = small.pop_front();
+        small_bytes -= node->data;
+        if (node->freq >= S3FIFO_MOVE_TO_MAIN) {
+            node->freq = 0;
+            node->in_main = true;
+            main.push_back(node);
+            main_bytes += node->data;
+            promoted++;
+            continue;
+        }
+        remember_ghost(key_hash(node->key));
+        evicted_small++;
+        evict(node);
+        return;
+    }
+}
+
+/* Gives entries with hits left another round, evicts the first without */
+void S3FIFOEviction::evict_main() {
+    while (!main.empty()) {
+        S3FIFOEvictionEntry* node = main.pop_front();
+        if (node->freq > 0) {
+            node->freq--;
+            main.push_back(node);
+            reinserted++;
+            continue;
+        }
+        main_bytes -= node->data;
+        evicted_main++;
+        evict(node);
+        return;
+    }
+}
+
+void S3FIFOEviction::evict(S3FIFOEvictionEntry* node) {
+    current_size -= node->data;
+    _mapping.erase(node->key);
+    delete node;
+}
+
+unsigned long long S3FIFOEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long S3FIFOEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void S3FIFOEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << small_bytes << " "
+        << main_bytes << " "
+        << small.size() << " "
+        << main.size() << " "
+        << ghost_index.size() << " "
+        << small_hits << " "
+        << main_hits << " "
+        << promoted << " "
+        << reinserted << " "
+        << ghost_hits << " "
+        << evicted_small << " "
+        << evicted_main << " ";
+
+    small_hits = 0;
+    main_hits = 0;
+    promoted = 0;
+    reinserted = 0;
+    ghost_hits = 0;
+    evicted_small = 0;
+    evicted_main = 0;
+}
@@ -26,33 +26,45 @@ using namespace std;
 
 S4LRUEviction::S4LRUEviction(unsigned long long size, unsigned short queue_count,
                              string id, const EmConfItems * sci){
+    init(size, vector<double>(queue_count, 1.0), id, sci);
+}
+
+S4LRUEviction::S4LRUEviction(unsigned long long size, vector<double> shares,
+                             string id, const EmConfItems * sci){
+    init(size, shares, id, sci);
+}
+
+void S4LRUEviction::init(unsigned long long size, vector<double> shares,
+                         string id, const EmConfItems * sci){
     name = "s4lru";
     this->sci = sci;
 
-    current_size = 0;
-    total_capacity = size / queue_count;
+    assert(shares.size() > 0);
+    total_capacity = size;
     cache_id = id;
 
-    current_size = new unsigned long long[queue_count];
-
-    this->queue_count = queue_count;
-    head = new S4LRUEvictionEntry*[queue_count];
-    tail = new S4LRUEvictionEntry*[queue_count];
-
+    queue_count = shares.size();
+    segment_shares = shares;
+    segments.resize(queue_count);
 
     for (int i = 0; i < queue_count; i++) {
         // Actually make the obj
-        head[i] = new S4LRUEvictionEntry;
-        tail[i] = new S4LRUEvictionEntry;
-        current_size[i] = 0;
-
-
-        (head[i])-> prev = NULL;
-        (head[i])-> next = tail[i];
-        (tail[i])-> next = NULL;
-        (tail[i])-> prev = head[i];
-
+        S4LRUSegment& seg = segments[i];
+        seg.head = new S4LRUEvictionEntry;
+        seg.tail = new S4LRUEvictionEntry;
+        seg.bytes = 0;
+
+        seg.head-> prev = NULL;
+        seg.head-> next = seg.tail;
+        seg.tail-> next = NULL;
+        seg.tail-> prev = seg.head;
+
+        seg.hits = 0;
+        seg.hit_bytes = 0;
+        seg.promoted = 0;
+        seg.demoted = 0;
     }
+    set_segment_capacities();
 
     previous_hour_timestamp = 0;
     total_items_purged = 0;
@@ -92,8 +104,20 @@ S4LRUEviction::S4LRUEviction(unsigned long long size, unsigned short queue_count
 
 S4LRUEviction::~S4LRUEviction()
 {
-    delete [] head;
-    delete [] tail;
+    for (int i = 0; i < queue_count; i++) {
+        delete segments[i].head;
+        delete segments[i].tail;
+    }
+}
+
+void S4LRUEviction::set_segment_capacities() {
+    double share_sum = 0;
+    for (int i = 0; i < queue_count; i++) {
+        share_sum += segment_shares[i];
+    }
+    for (int i = 0; i < queue_count; i++) {
+        segments[i].capacity = total_capacity * (segment_shares[i] / share_sum);
+    }
 }
 
 
@@ -164,8 +188,10 @@ unsigned long long S4LRUEviction::put(string key, unsigned long data, unsigned l
         }
 
 
+        segments[0].promoted++;
+
         // Don't let it go over disk size!
-        purge_regular();
+        cascade(0);
 
 
     }
@@ -177,14 +203,21 @@ unsigned long S4LRUEviction::get(string key, unsigned long ts, unsigned long byt
     S4LRUEvictionEntry* node = _mapping[key];
     if(node)
     {
+        unsigned short queue = node->queue;
+        segments[queue].hits++;
+        segments[queue].hit_bytes += bytes_out;
+
         detach(node);
         // You got fetched! You get promoted to next queue
-        attach(node, node->queue + 1);
+        attach(node, queue + 1);
         node->count = node->count + 1;
 
         // Actually we also need to purge here -- since you maybe filled up
         // a queue with the move
-        purge_regular();
+        if (node->queue != queue) {
+            segments[node->queue].promoted++;
+            cascade(node->queue);
+        }
 
         avg_oldest_requested_file_vector.push_back(node->timestamp);
 
@@ -231,64 +264,88 @@ int S4LRUEviction::check(string key, unsigned long ts)	// to check if present.
  * default purge: we delete the least recently requested file
  */
 bool S4LRUEviction::purge_regular() {
+    S4LRUEvictionEntry* node = segments[0].tail->prev;
+    if(node == segments[0].head) {
+        return false;
+    }
 
-    // Here, we have to loop through queues and move backwards
-    for (int j = queue_count - 1; j >= 0; j--) {
+    segments[0].demoted++;
+    evict(node);
+    return true;
+}
 
-        while(current_size[j] > total_capacity) {
-            S4LRUEvictionEntry* node = tail[j]->prev;	//switch 1 of 2; for LRU vs. MRU; LRU(tail->prev); 		MRU(head->next)
-            if(node == head[j]) {							//switch 2 of 2; for LRU vs. MRU; LRU(node == head); 	MRU(node == tail)
-                return false;
-            }
+/* The bottom segment's tail first, as many as putting incoming would evict */
+bool S4LRUEviction::peek_victims(unsigned long long incoming, size_t max_victims,
+                                 vector<pair<string, unsigned long> >& victims) {
+    victims.clear();
+    S4LRUSegment& seg = segments[0];
+    unsigned long long freed = 0;
+    for (S4LRUEvictionEntry* node = seg.tail->prev;
+         node != seg.head && seg.bytes + incoming - freed > seg.capacity
+         && victims.size() < max_victims;
+         node = node->prev) {
+        victims.push_back(make_pair(node->key, node->data));
+        freed += node->data;
+    }
+    return true;
+}
 
-            // S4LRUEvictionEntry* headNode = head->next;
-            // cout << "\npurge_regular " << headNode->timestamp << " " << node->timestamp << " " << node->data << " " << node->key << "\n";
-            // It has to leave this queue, detach it
-            detach(node);
+void S4LRUEviction::cascade(unsigned short queue) {
+    // Here, we have to loop through queues and move backwards
+    for (int j = queue; j >= 0; j--) {
+        S4LRUSegment& seg = segments[j];
+        if (seg.bytes <= seg.capacity) {
+            break;
+        }
+
+        while(seg.bytes > seg.capacity) {
+            S4LRUEvictionEntry* node = seg.tail->prev;
+            seg.demoted++;
 
             // We are at the bottom...
-            if (node->queue == 0) {
-                // Log some stats
-                /* Only do this stuff if its getting kicked out all the way */
-                if(sci->print_hdd_egress_stats) {
-                    egress_total_count++;
-                    egress_total_size += node->data;
-
-                    if(current_ingress_item_timestamp - previous_hour_timestamp_egress > 3600) {
-                        previous_hour_timestamp_egress = current_ingress_item_timestamp;
-
-                        cout << "\nprint_hourly_hdd_egress_stats "
-                            << current_ingress_item_timestamp << " "
-                            << egress_total_count << " "
-                            << egress_total_size << " "
-                            << "\n";
-                        egress_total_count = 0;
-                        egress_total_size = 0;
-                    }
-                }
-                // Clean out the node
-                _mapping.erase(node->key);
-                delete node;
-                --cache_item_count;
+            if (j == 0) {
+                evict(node);
             }
             else {
                 // Ok here, it's just getting bumped down a level
+                detach(node);
                 attach(node, j - 1);
             }
-
-
         }
     }
-    return true;
+}
 
+void S4LRUEviction::evict(S4LRUEvictionEntry* node) {
+    detach(node);
 
+    /* Only do this stuff if its getting kicked out all the way */
+    if(sci->print_hdd_egress_stats) {
+        egress_total_count++;
+        egress_total_size += node->data;
+
+        if(current_ingress_item_timestamp - previous_hour_timestamp_egress > 3600) {
+            previous_hour_timestamp_egress = current_ingress_item_timestamp;
+
+            cout << "\nprint_hourly_hdd_egress_stats "
+                << current_ingress_item_timestamp << " "
+                << egress_total_count << " "
+                << egress_total_size << " "
+                << "\n";
+            egress_total_count = 0;
+            egress_total_size = 0;
+        }
+    }
+    // Clean out the node
+    _mapping.erase(node->key);
+    delete node;
+    --cache_item_count;
 }
 
 unsigned long long S4LRUEviction::get_size() {
     unsigned long long total_size = 0;
 
     for (int i=0; i < queue_count; i++) {
-        total_size += current_size[i];
+        total_size += segments[i].bytes;
     }
     return total_size;
 }
@@ -298,7 +355,9 @@ unsigned long long S4LRUEviction::get_total_capacity() {
 }
 
 void S4LRUEviction::set_total_capacity_by_value(unsigned long long size) {
-    total_capacity = size/queue_count;
+    total_capacity = size;
+    set_segment_capacities();
+    cascade(queue_count - 1);
 }
 
 
@@ -308,10 +367,7 @@ void S4LRUEviction::detach(S4LRUEvictionEntry* node)
     node->prev->next = node->next;
     node->next->prev = node->prev;
     // Need the queue to know how to remove
-    unsigned short queue = node->queue;
-
-
-    current_size[queue] = current_size[queue] - node->data;
+    segments[node->queue].bytes -= node->data;
 }
 
 void S4LRUEviction::attach(S4LRUEvictionEntry* node, unsigned short queue)
@@ -321,11 +377,12 @@ void S4LRUEviction::attach(S4LRUEvictionEntry* node, unsigned short queue)
         queue = queue_count - 1;
     }
 
-    node->next = head[queue]->next;
-    node->prev = head[queue];
-    head[queue]->next = node;
+    S4LRUSegment& seg = segments[queue];
+    node->next = seg.head->next;
+    node->prev = seg.head;
+    seg.head->next = node;
     node->next->prev = node;
-    current_size[queue] = current_size[queue] + node->data;
+    seg.bytes += node->data;
 
     // Set the queue in the node
     node-> queue = queue; // Everything starts in queue 0
@@ -355,5 +412,21 @@ void S4LRUEviction::periodic_output(unsigned long ts, std::ostringstream& outlog
     outlogfile << get_size() << " ";
     // Oldest file age
 
+    // Per segment: bytes, capacity, hits, hit bytes, promoted in, demoted out
+    outlogfile << queue_count << " ";
+    for (int i = 0; i < queue_count; i++) {
+        S4LRUSegment& seg = segments[i];
+        outlogfile << seg.bytes << " "
+            << seg.capacity << " "
+            << seg.hits << " "
+            << seg.hit_bytes << " "
+            << seg.promoted << " "
+            << seg.demoted << " ";
+
+        seg.hits = 0;
+        seg.hit_bytes = 0;
+        seg.promoted = 0;
+        seg.demoted = 0;
+    }
 }
 
@@ -0,0 +1,321 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+/*
+ * Sampled eviction: score K random entries, evict the worst
+ *
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "sampled_eviction.h"
+
+using namespace std;
+
+SampleScorer::~SampleScorer() {}
+
+FormulaScorer::FormulaScorer(const EmConfItems* sci, int eviction_formula, int ef4_y, float ef4_e) {
+    this->sci = sci;
+    this->eviction_formula = eviction_formula;
+    this->ef4_y = ef4_y;
+    this->ef4_e = ef4_e;
+    w_size = sci->w_size;
+    w_age = sci->w_age;
+}
+
+string FormulaScorer::get_name() {
+    ostringstream o;
+    o << "formula" << eviction_formula;
+    return o.str();
+}
+
+double FormulaScorer::score(const SampledEvictionEntry* node, const SampleContext& ctx) {
+    int deviations = 4;
+    double log_size = log2(node->data > 1 ? node->data : 1);
+
+    double upper_range = ctx.size_mu + deviations * sqrt(ctx.size_var);
+    double lower_range = ctx.size_mu - deviations * sqrt(ctx.size_var);
+
+    double size_score = 0;
+    if (log_size >= upper_range) {
+        size_score = 1;
+    } else if (log_size <= lower_range) {
+        size_score = 0;
+    } else {
+        size_score = 0.5 + ((log_size - ctx.size_mu) / (2 * deviations * sqrt(ctx.size_var)));
+    }
+
+    unsigned long age = ctx.now - node->timestamp;
+    double age_score = 0;
+    if (ctx.age_range > 0) {
+        age_score = (double) age / ctx.age_range;
+    }
+
+    double eviction_score = 0;
+    if (1 == eviction_formula) {
+        eviction_score = (age_score * w_age) + (size_score * w_size);
+    }
+    else if (2 == eviction_formula) {
+        double saiflish_perf = 0.5;
+        if (sci->check_customer_in_list(node->customer_id, sci->no_bf_cust)) {
+            // added on 1st hit, push these further towards the end
+            saiflish_perf = 1;
+        }
+        eviction_score = ((age_score * w_age) + (size_score * w_size)) * saiflish_perf;
+    }
+    else if (3 == eviction_formula) {
+        eviction_score = age * (size_score * w_size);
+    }
+    else if (4 == eviction_formula) {
+        // A_i^y * (S_i * w + E)
+        eviction_score = pow(age, ef4_y) * ((size_score * w_size) + ef4_e);
+    }
+    else if (5 == eviction_formula) {
+        // A_i^y * (S_i * w + A_i)
+        eviction_score = pow(age, ef4_y) * ((size_score * w_size) + age);
+    }
+    else if (6 == eviction_formula) {
+        // A_i^y + (S_i * w * A_i)
+        eviction_score = pow(age, ef4_y) + ((size_score * w_size) * age);
+    }
+    else if (7 == eviction_formula) {
+        // A_i^y  * (w_s * A_0 * S + e)
+        eviction_score = pow(age, ef4_y) * ((size_score * w_size * ctx.age_range) + ef4_e);
+    }
+    else if (8 == eviction_formula) {
+        // same as eviction_formula 1, but every lru_interval hours we do a regular LRU
+        if (0 == ctx.hour_count % sci->lru_interval) {
+            eviction_score = age_score;
+        }
+        else {
+            eviction_score = (age_score * w_age) + (size_score * w_size);
+        }
+    }
+    else {
+        cout << "\nUndefined value of eviction_formula. Exiting.\n";
+        exit(1);
+    }
+    return eviction_score;
+}
+
+string AgeScorer::get_name() {
+    return "age";
+}
+
+double AgeScorer::score(const SampledEvictionEntry* node, const SampleContext& ctx) {
+    return ctx.now - node->timestamp;
+}
+
+string FrequencyScorer::get_name() {
+    return "frequency";
+}
+
+double FrequencyScorer::score(const SampledEvictionEntry* node, const SampleContext& ctx) {
+    // requests per second in cache, lowest goes first
+    return - (double) node->count / (ctx.now - node->inserted + 1);
+}
+
+string SizeAgeScorer::get_name() {
+    return "size_age";
+}
+
+double SizeAgeScorer::score(const SampledEvictionEntry* node, const SampleContext& ctx) {
+    return (double) (ctx.now - node->timestamp + 1) * node->data;
+}
+
+SampleScorer* make_sample_scorer(const string& name, const EmConfItems* sci) {
+    if (name == "formula") {
+        return new FormulaScorer(sci, sci->eviction_formula, sci->ef4_y, sci->ef4_e);
+    }
+    if (name == "age") {
+        return new AgeScorer();
+    }
+    if (name == "frequency") {
+        return new FrequencyScorer();
+    }
+    if (name == "size_age") {
+        return new SizeAgeScorer();
+    }
+    return NULL;
+}
+
+
+SampledEviction::SampledEviction(unsigned long long size, string id, const EmConfItems * sci,
+                                 SampleScorer* scorer){
+    name = "sampled";
+    this->sci = sci;
+    this->scorer = scorer;
+
+    total_capacity = size;
+    cache_id = id;
+    current_size = 0;
+
+    sample_count = sci->eviction_samples;
+    last_timestamp = 0;
+    hour_count = 0;
+
+    running_size_mu = 0;
+    running_size_var = 0;
+    alpha_running_size_mu = 0.25;
+    alpha_running_size_var = 0.25;
+
+    evicted_count = 0;
+    evicted_bytes = 0;
+    evicted_score_sum = 0;
+}
+
+SampledEviction::~SampledEviction()
+{
+    for (size_t i = 0; i < entries.size(); i++) {
+        delete entries[i];
+    }
+    delete scorer;
+}
+
+void SampledEviction::hourly_purging(unsigned long timestamp) {
+    hour_count++;
+    while (current_size > total_capacity * .80) {
+        purge_regular();
+    }
+}
+
+unsigned long long SampledEviction::put(string key, unsigned long data, unsigned long timestamp, unsigned long bytes_out, string customer_id, string orig_url)
+{
+    assert(_mapping.find(key) == _mapping.end()); // we always 'check' before we 'put'.
+
+    SampledEvictionEntry* node = new SampledEvictionEntry;
+    node->key = key;
+    node->data = data;
+    node->timestamp = timestamp;
+    node->inserted = timestamp;
+    node->customer_id = customer_id;
+    node->orig_url = orig_url;
+    node->count = 1;
+    node->slot = entries.size();
+    entries.push_back(node);
+    _mapping[key] = node;
+    current_size += data;
+    last_timestamp = timestamp;
+    update_size_running_mean(data);
+
+    // Don't let it go over disk size!
+    while (current_size > total_capacity) {
+        purge_regular();
+    }
+    return current_size;
+}
+
+unsigned long SampledEviction::get(string key, unsigned long ts, unsigned long bytes_out, string url_original)
+{
+    unordered_map<string, SampledEvictionEntry*>::iterator it = _mapping.find(key);
+    assert(it != _mapping.end()); // we always 'check' before we 'get'.
+
+    SampledEvictionEntry* node = it->second;
+    node->count++;
+    node->timestamp = ts;
+    last_timestamp = ts;
+    update_size_running_mean(node->data);
+    return node->data;
+}
+
+int SampledEviction::check(string key, unsigned long ts)	// to check if present.
+{
+    return _mapping.find(key) != _mapping.end();
+}
+
+bool SampledEviction::purge_regular() {
+    if (entries.empty()) {
+        return false;
+    }
+
+    // Small cache, just look at everything
+    sample.clear();
+    if (entries.size() <= sample_count) {
+        sample = entries;
+    }
+    else {
+        for (unsigned int i = 0; i < sample_count; i++) {
+            sample.push_back(entries[rng.below(entries.size())]);
+        }
+    }
+
+    SampleContext ctx;
+    ctx.now = last_timestamp;
+    ctx.age_range = 0;
+    ctx.size_mu = running_size_mu;
+    ctx.size_var = running_size_var;
+    ctx.hour_count = hour_count;
+    for (size_t i = 0; i < sample.size(); i++) {
+        if (ctx.now - sample[i]->timestamp > ctx.age_range) {
+            ctx.age_range = ctx.now - sample[i]->timestamp;
+        }
+    }
+
+    SampledEvictionEntry* victim = sample[0];
+    double victim_score = scorer->score(victim, ctx);
+    for (size_t i = 1; i < sample.size(); i++) {
+        double s = scorer->score(sample[i], ctx);
+        if (s > victim_score) {
+            victim = sample[i];
+            victim_score = s;
+        }
+    }
+
+    evicted_count++;
+    evicted_bytes += victim->data;
+    evicted_score_sum += victim_score;
+    evict(victim);
+    return true;
+}
+
+/* Swap with the last slot and pop, keeps the array dense */
+void SampledEviction::evict(SampledEvictionEntry* node) {
+    SampledEvictionEntry* last = entries.back();
+    entries[node->slot] = last;
+    last->slot = node->slot;
+    entries.pop_back();
+
+    current_size -= node->data;
+    _mapping.erase(node->key);
+    delete node;
+}
+
+void SampledEviction::update_size_running_mean(unsigned long size) {
+    if (0 == size) { size = 1; }
+    running_size_mu = (alpha_running_size_mu * log2(size)) + ((1 - alpha_running_size_mu) * running_size_mu);
+    double current_var = pow(log2(size) - running_size_mu, 2);
+    running_size_var = (alpha_running_size_var * current_var) + ((1 - alpha_running_size_var) * running_size_var);
+}
+
+unsigned long long SampledEviction::get_size() {
+    return current_size;
+}
+
+unsigned long long SampledEviction::get_total_capacity() {
+    return total_capacity;
+}
+
+void SampledEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << get_size() << " "
+        << entries.size() << " "
+        << sample_count << " "
+        << scorer->get_name() << " "
+        << evicted_count << " "
+        << evicted_bytes << " "
+        << (evicted_count ? evicted_score_sum / evicted_count : 0) << " ";
+
+    evicted_count = 0;
+    evicted_bytes = 0;
+    evicted_score_sum = 0;
+}
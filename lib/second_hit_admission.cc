@@ -7,28 +7,93 @@
  *
  */
 
+#include <stdlib.h>
 #include <algorithm>
+#include <iostream>
 #include <string>
 #include <sstream>
 #include <vector>
 #include "bloomfilter.h"
 #include "cache_policy.h"
+#include "customer_thresholds.h"
 #include "second_hit_admission.h"
 
 using namespace std;
 
+/*
+ * Per customer N from the thresholds table, 0 when the customer has no entry.
+ * Returns true when the table alone decides, with the answer in admit.
+ */
+static bool customer_decides(const CustomerThresholds* table, const string& customer_id_str,
+                             unsigned long long size, int& n, bool& admit) {
+    n = 0;
+    const CustomerThreshold* t = table ? table->find(customer_id_str) : NULL;
+    if (t == NULL) {
+        return false;
+    }
+    if (t->max_size && size >= t->max_size) {
+        admit = false;
+        return true;
+    }
+    if (t->nval == 0) {
+        admit = true;
+        return true;
+    }
+    n = t->nval;
+    return false;
+}
+
+static inline bool bf_check(AdmissionBloomFilter* BF, AdmissionBloomFilter::key_type bf_key, int n) {
+    return n ? BF->check(bf_key, n) : BF->check(bf_key);
+}
+
+static inline void bf_add(AdmissionBloomFilter* BF, AdmissionBloomFilter::key_type bf_key, int n) {
+    if (n) {
+        BF->add(bf_key, n);
+    } else {
+        BF->add(bf_key);
+    }
+}
+
+/* "bkdr" keeps the bloom filter's per-function bkdr hashes */
+static hash64_fn admission_hash(const string& hash_name) {
+    if (hash_name == "bkdr") {
+        return NULL;
+    }
+    hash64_fn fn = find_hash(hash_name.c_str());
+    if (fn == NULL) {
+        cerr << "\nUnknown bloom filter hash " << hash_name << ". Exiting.\n";
+        exit(1);
+    }
+    return fn;
+}
+
 SecondHitAdmission::SecondHitAdmission(string file_name, size_t _nfuncs,
                                         unsigned long size, int _NVAL,
                                         vector<string> no_bf_cust) {
     name = "2hc";
     this->no_bf_cust = no_bf_cust;
-    BF  = new BloomFilter ((char *)file_name.c_str(), _nfuncs, size, _NVAL);
+    customer_nval = NULL;
+    BF  = new AdmissionBloomFilter ((char *)file_name.c_str(), _nfuncs, size, _NVAL);
 }
 
 SecondHitAdmission::~SecondHitAdmission() {
     delete BF;
 }
 
+void SecondHitAdmission::set_customer_nval(const CustomerThresholds* table) {
+    customer_nval = (table && !table->empty()) ? table : NULL;
+}
+
+void SecondHitAdmission::set_hash(string hash_name) {
+    hash64_fn fn = admission_hash(hash_name);
+#ifdef BLOCKED_BF
+    (void) fn; // probes always come from murmur3_128, see BlockedBloomFilter::make_key
+#else
+    BF->set_hash(fn);
+#endif
+}
+
 // Should we let this in?
 bool SecondHitAdmission::check(string key, unsigned long data, unsigned long long size,
                                unsigned long ts, string customer_id_str) {
@@ -41,12 +106,19 @@ bool SecondHitAdmission::check(string key, unsigned long data, unsigned long lon
         return true;
     }
 
+    int n;
+    bool admit;
+    if (customer_decides(customer_nval, customer_id_str, size, n, admit)) {
+        return admit;
+    }
+
     // We have it in the bloom filter, go ahead and accept it!
-    if (BF->check((char *)key.c_str())) {
+    AdmissionBloomFilter::key_type bf_key = AdmissionBloomFilter::make_key(key.c_str());
+    if (bf_check(BF, bf_key, n)) {
         return true;
     } else {
         // We don't have it, let's add it, and return false
-        BF->add((char *)key.c_str());
+        bf_add(BF, bf_key, n);
         return false;
     }
 
@@ -77,57 +149,94 @@ void SecondHitAdmission::periodic_output(unsigned long ts, std::ostringstream& o
 
 /****************************
  * 
- * 2 Rotating Bloom Filters 
+ * Ring of rotating Bloom Filters 
  *
  ****************************/
 SecondHitAdmissionRot::SecondHitAdmissionRot(string file_name, size_t _nfuncs,
                                         unsigned long size, int _NVAL,
                                         vector<string> no_bf_cust,
                                         unsigned long max_age) {
-
-    name = "2hc_rot";
     /* Save all the init garbage */
     this->file_name = file_name;
     this->_nfuncs = _nfuncs;
     this->bf_size = size;
     this->_NVAL = _NVAL;
+    this->no_bf_cust = no_bf_cust;
+    this->max_age = max_age;
 
-    /* Make one BF */
-    head = new BFEntry;
-
-    head->BF = new BloomFilter ((char *)file_name.c_str(), _nfuncs, size, _NVAL);
-    head->init_time = 0; // Needs clever handling down stream
-    head->next = NULL;
+    init(2);
+}
 
-    /* Fill in the other junk */
+SecondHitAdmissionRot::SecondHitAdmissionRot(string file_name, size_t _nfuncs,
+                                        unsigned long size, int _NVAL,
+                                        vector<string> no_bf_cust,
+                                        unsigned long max_age,
+                                        unsigned int generations) {
+    this->file_name = file_name;
+    this->_nfuncs = _nfuncs;
+    this->bf_size = size;
+    this->_NVAL = _NVAL;
     this->no_bf_cust = no_bf_cust;
     this->max_age = max_age;
 
+    init(generations);
+}
+
+void SecondHitAdmissionRot::init(unsigned int generations) {
+    name = "2hc_rot";
+
+    if (generations < 2) {
+        cerr << "\nSecondHitAdmissionRot needs at least 2 generations. Exiting.\n";
+        exit(1);
+    }
+    generation_span = 2 * max_age / generations;
+
+    /* All the filters up front, rotation only clears them */
+    ring.resize(generations);
+    for (unsigned int i = 0; i < ring.size(); i++) {
+        ring[i].BF = new AdmissionBloomFilter ((char *)file_name.c_str(), _nfuncs, bf_size, _NVAL);
+        ring[i].init_time = 0;
+    }
+    newest = 0;
+    live = 1;
+    customer_nval = NULL;
 }
 
 SecondHitAdmissionRot::~SecondHitAdmissionRot() {
-    /* Here, we have to walk our list and delete as we go */
-    BFEntry *curr = head;
-    BFEntry *next_entry;
+    for (unsigned int i = 0; i < ring.size(); i++) {
+        delete ring[i].BF;
+    }
+}
+
+void SecondHitAdmissionRot::set_customer_nval(const CustomerThresholds* table) {
+    customer_nval = (table && !table->empty()) ? table : NULL;
+}
 
-    while (curr != NULL) {
-        /* Delete the BF inside */
-        delete curr->BF;
-        /* Get the next one */
-        next_entry = curr->next;
-        /* Delete the durrent one*/
-        delete curr;
-        /* Pass pointer */
-        curr = next_entry;
+void SecondHitAdmissionRot::set_hash(string hash_name) {
+    hash64_fn fn = admission_hash(hash_name);
+#ifdef BLOCKED_BF
+    (void) fn; // probes always come from murmur3_128, see BlockedBloomFilter::make_key
+#else
+    for (unsigned int i = 0; i < ring.size(); i++) {
+        ring[i].BF->set_hash(fn);
     }
+#endif
+}
 
+/* The oldest generation is cleared and becomes the newest */
+void SecondHitAdmissionRot::rotate(unsigned long ts) {
+    newest = (newest + ring.size() - 1) % ring.size();
+    ring[newest].BF->flush();
+    ring[newest].init_time = ts;
+    if (live < ring.size()) {
+        live++;
+    }
 }
 
 // Should we let this in?
 bool SecondHitAdmissionRot::check(string key, unsigned long data, unsigned long long size,
                                unsigned long ts, string customer_id_str) {
 
-    BFEntry* new_bf;
     unsigned long age;
 
     // Check to see if this customer bypasses the bloom filter. If so, just let
@@ -137,56 +246,47 @@ bool SecondHitAdmissionRot::check(string key, unsigned long data, unsigned long
         return true;
     }
 
-    /* Check the age on the head, is it time to rotate */
-    if (head->init_time == 0) {
+    /* Check the age on the newest, is it time to rotate */
+    if (ring[newest].init_time == 0) {
         /* If it was the init, take the current time as the start */
-        head->init_time = ts;
+        ring[newest].init_time = ts;
     }
-    age = ts - head->init_time;
+    age = ts - ring[newest].init_time;
     /* It's time to rotate*/
-    if (age > max_age) {
-        // Check the next guy, delete him if he exists
-        // Probably thhis should be a loop and not just a look ahead of 1
+    if (age > generation_span) {
         cout << "Rotating BF!" << endl;
-        if (head->next != NULL) {
-            delete head->next->BF;
-            delete head->next;
-            head->next = NULL;
+        rotate(ts);
+        // Idle for more spans than that, those generations are stale too
+        for (unsigned long stale = age / generation_span;
+             stale > 1 && live > 1; stale--) {
+            live--;
         }
-        // Make a new one and stick it at the head
-        new_bf = new BFEntry;
-        new_bf->BF = new BloomFilter ((char *)file_name.c_str(), _nfuncs, bf_size, _NVAL);
-        new_bf->init_time = ts; // Now
-        new_bf->next = head;
-        // stick it in front
-        head = new_bf;
-
         cout << "Done rotating BF!" << endl;
     }
 
-    // Ok now we start climbing down
-    if (head->BF->check((char *)key.c_str())) {
+    int n;
+    bool admit;
+    if (customer_decides(customer_nval, customer_id_str, size, n, admit)) {
+        return admit;
+    }
+
+    // Ok now we start climbing down, hashing the key only once
+    AdmissionBloomFilter::key_type bf_key = AdmissionBloomFilter::make_key(key.c_str());
+    if (bf_check(ring[newest].BF, bf_key, n)) {
         return true;
-    } else {
-        // We don't have it, let's add it
-        head->BF->add((char *)key.c_str());
+    }
+
+    // We don't have it, let's add it
+    bf_add(ring[newest].BF, bf_key, n);
 
-        // Now let's check the next one
-        if ((head->next != NULL) &&
-            (head->next->BF->check((char *)key.c_str()))) {
-            // We had it in the old one, let it in
+    // Now the older ones, newest first
+    for (unsigned int i = 1; i < live; i++) {
+        if (bf_check(ring[(newest + i) % ring.size()].BF, bf_key, n)) {
+            // We had it in an old one, let it in
             return true;
-        } else {
-            // Else, either:
-            //  not in the old one, return false
-            //  There is no old one, return false
-            return false;
         }
     }
-
-
-    cout << "unexpected!" << endl;
-
+    return false;
 }
 
 bool SecondHitAdmissionRot::check_customer_in_list(string custid) const{
@@ -199,7 +299,7 @@ bool SecondHitAdmissionRot::check_customer_in_list(string custid) const{
 
 float SecondHitAdmissionRot::get_fill_percentage() {
     struct bloom_filter_stats bfstats;
-    head->BF->get_live_stats(bfstats);
+    ring[newest].BF->get_live_stats(bfstats);
     return bfstats.fill_percentage;
 }
 
@@ -19,6 +19,8 @@
 #include <iomanip>
 #include <fstream>
 #include <sstream>
+#include <limits.h>
+#include <math.h>
 #include <string.h>
 #include <string>
 #include <unordered_map>
@@ -180,6 +182,14 @@ EmConfItems::EmConfItems() {
 	//hd_gig = 200;
 
     bf_reset_int = 604800; // 7 days in seconds
+    bf_generations = 2;
+    bf_hash = "bkdr";
+    seed = time(NULL);
+    tinylfu_width = 1 << 20;
+    cuckoo_slots = 1 << 24;
+    cuckoo_delete_on_admit = false;
+    learned_admission_threshold = .5;
+    learned_admission_window = 0;
 
 	char buff[20];
 	time_t now = time(NULL);
@@ -199,6 +209,12 @@ EmConfItems::EmConfItems() {
     admission_size = 1024 * 1024 * 1024;
     admission_prob = .5;
     hoc_ttl = 0;
+    eviction_samples = 16;
+    sample_scorer = "formula";
+    clock_bits = 1;
+    gdsf_cost = "1";
+    lirs_hir_share = .1;
+    lrb_window = 100000;
 
     hd_gig = 1000;
     kc_gig = 2;
@@ -218,6 +234,7 @@ EmConfItems::EmConfItems() {
 	LRU_list_size = 1000*10;
 	regular_purge_interval = 12;
 	floor_customer_loss = false;
+	customer_fair_eviction = false;
 
 	enable_probabilistic_bf_add = false;
 	w_size = 0;
@@ -254,6 +271,14 @@ void EmConfItems::print_em_conf_items() {
 			<< setw(50) << "read_em_dir " << setw(50) << read_em_dir << endl
 
             << setw(50) << "bf_reset_int" << setw(50) << bf_reset_int << endl
+            << setw(50) << "bf_generations" << setw(50) << bf_generations << endl
+            << setw(50) << "bf_hash" << setw(50) << bf_hash << endl
+            << setw(50) << "seed" << setw(50) << seed << endl
+            << setw(50) << "tinylfu_width" << setw(50) << tinylfu_width << endl
+            << setw(50) << "cuckoo_slots" << setw(50) << cuckoo_slots << endl
+            << setw(50) << "cuckoo_delete_on_admit" << setw(50) << cuckoo_delete_on_admit << endl
+            << setw(50) << "learned_admission_threshold" << setw(50) << learned_admission_threshold << endl
+            << setw(50) << "learned_admission_window" << setw(50) << learned_admission_window << endl
 
 			<< setw(50) << "periodic_reporting_logs_path " << setw(50) << periodic_reporting_logs_path << endl
 			<< setw(50) << "periodic_reporting_err_logs_path" << setw(50) << periodic_reporting_err_logs_path << endl
@@ -266,6 +291,13 @@ void EmConfItems::print_em_conf_items() {
             << setw(50) << "admission_size" << setw(50) << admission_size << endl
             << setw(50) << "admission_prob" << setw(50) << admission_prob << endl
             << setw(50) << "hoc_ttl" << setw(50) << hoc_ttl<< endl
+            << setw(50) << "eviction_samples" << setw(50) << eviction_samples << endl
+            << setw(50) << "sample_scorer" << setw(50) << sample_scorer << endl
+            << setw(50) << "clock_bits" << setw(50) << clock_bits << endl
+            << setw(50) << "gdsf_cost" << setw(50) << gdsf_cost << endl
+            << setw(50) << "origin_cost customers" << setw(50) << origin_cost.size() << endl
+            << setw(50) << "lirs_hir_share" << setw(50) << lirs_hir_share << endl
+            << setw(50) << "lrb_window" << setw(50) << lrb_window << endl
 
 			<< setw(50) << "second_hit_caching_hd" << setw(50) << second_hit_caching_hd << endl
 			<< setw(50) << "second_hit_caching_kc" << setw(50) << second_hit_caching_kc << endl
@@ -286,6 +318,7 @@ void EmConfItems::print_em_conf_items() {
 
 			<< setw(50) << "regular_purge_interval" << setw(50) << regular_purge_interval << endl
 			<< setw(50) << "floor_customer_loss" << setw(50) << floor_customer_loss << endl
+			<< setw(50) << "customer_fair_eviction" << setw(50) << customer_fair_eviction << endl
 			<< setw(50) << "generate_bf_stats" << setw(50) << generate_bf_stats << endl
 			<< setw(50) << "lru_interval" << setw(50) << lru_interval << endl
 			<< setw(50) << "debug " << setw(50) << debug << endl
@@ -296,15 +329,55 @@ void EmConfItems::print_em_conf_items() {
 	cout << "\nmonitor_customers (monitor them for stats)" << "\t  ";
 	for(vector<string>::const_iterator i = monitor_customers_list.begin(); i != monitor_customers_list.end(); ++i)
 		cout << *i << ' ';
+	cout << "\ncustomer_nval (per customer N[:max size])" << "\t  ";
+	customer_nval.print(cout);
+	cout << "\ns4lru_segment_shares" << "\t\t\t\t\t  ";
+	for(vector<double>::const_iterator i = s4lru_segment_shares.begin(); i != s4lru_segment_shares.end(); ++i)
+		cout << *i << ' ';
 	cout << "\n\n";
 }
 
+/* "id:cost,..." into costs, false on a malformed entry */
+static bool parse_origin_cost(const string& spec, unordered_map<string, double>& costs) {
+    istringstream ss(spec);
+    string entry;
+    while (getline(ss, entry, ',')) {
+        size_t colon = entry.find(':');
+        if (colon == string::npos || colon == 0 || colon + 1 == entry.size()) {
+            return false;
+        }
+        char* end;
+        double cost = strtod(entry.c_str() + colon + 1, &end);
+        if (*end != '\0' || cost < 0) {
+            return false;
+        }
+        costs[entry.substr(0, colon)] = cost;
+    }
+    return true;
+}
+
+/* "share,..." into shares, false unless all are finite and above 0 */
+static bool parse_segment_shares(const string& spec, vector<double>& shares) {
+    istringstream ss(spec);
+    string entry;
+    shares.clear(); // the last one given wins
+    while (getline(ss, entry, ',')) {
+        char* end;
+        double share = strtod(entry.c_str(), &end);
+        if (entry.empty() || *end != '\0' || !(share > 0) || isinf(share)) {
+            return false;
+        }
+        shares.push_back(share);
+    }
+    return !shares.empty();
+}
+
 void EmConfItems::command_line_parser(int argc, char* argv[]) {
 
     int c;
 
     // Let's go ahead and read all that getopt goodness
-	while ((c = getopt (argc, argv, "N:S:P:T:H:K:R:")) != -1)
+	while ((c = getopt (argc, argv, "N:S:P:T:H:K:R:G:Q:C:DF:s:U:L:B:W:O:I:M:A:V:")) != -1)
 		switch (c)
 		{
 			case 'N':
@@ -327,6 +400,63 @@ void EmConfItems::command_line_parser(int argc, char* argv[]) {
                 break;
             case 'R':
                 bf_reset_int = atoi(optarg);
+                break;
+            case 'G':
+                bf_generations = atoi(optarg);
+                break;
+            case 'U':
+                // comma separated id:n[:max_size], e.g. -U ACDC:3,CAFE:0
+                if (!customer_nval.parse(optarg)) {
+                    cerr << "\nBad -U entry in " << optarg << ". Exiting.\n";
+                    exit(1);
+                }
+                break;
+            case 'L':
+                tinylfu_width = atol(optarg);
+                break;
+            case 'W':
+                gdsf_cost = optarg;
+                break;
+            case 'O':
+                // comma separated id:cost, e.g. -O ACDC:2.5,CAFE:0.5
+                if (!parse_origin_cost(optarg, origin_cost)) {
+                    cerr << "\nBad -O entry in " << optarg << ". Exiting.\n";
+                    exit(1);
+                }
+                break;
+            case 'I':
+                lirs_hir_share = atof(optarg);
+                break;
+            case 'M':
+                lrb_window = atol(optarg);
+                break;
+            case 'A':
+                learned_admission_threshold = atof(optarg);
+                break;
+            case 'V':
+                learned_admission_window = atol(optarg);
+                break;
+            case 'B':
+                clock_bits = atoi(optarg);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'F':
+                bf_hash = optarg;
+                break;
+            case 'C':
+                cuckoo_slots = atol(optarg);
+                break;
+            case 'D':
+                cuckoo_delete_on_admit = true;
+                break;
+            case 'Q':
+                // comma separated, e.g. -Q 1,1,1,1
+                if (!parse_segment_shares(optarg, s4lru_segment_shares)) {
+                    cerr << "\nBad -Q shares in " << optarg << ". Exiting.\n";
+                    exit(1);
+                }
                 break;
 			default:
 				abort ();
@@ -386,6 +516,13 @@ void EmConfItems::config_file_parser(string input_config_file) {
 						}
 					}
 
+					if(tokens.at(0).compare("customer_nval") == 0) {
+						if (!customer_nval.parse(tokens.at(1))) {
+							cerr << "\nBad customer_nval entry in " << tokens.at(1) << ". Exiting.\n";
+							exit(1);
+						}
+					}
+
 					if(tokens.at(0).compare("monitor_customers") == 0) {
 						string str = tokens.at(1);
 						istringstream ss(str);
@@ -395,6 +532,85 @@ void EmConfItems::config_file_parser(string input_config_file) {
 						}
 					}
 
+					if(tokens.at(0).compare("s4lru_segment_shares") == 0) {
+						if (!parse_segment_shares(tokens.at(1), s4lru_segment_shares)) {
+							cerr << "\nBad s4lru_segment_shares in " << tokens.at(1) << ". Exiting.\n";
+							exit(1);
+						}
+					}
+
+					if(tokens.at(0).compare("bf_generations") == 0) {
+						bf_generations = atoi(tokens.at(1).c_str());
+					}
+
+					if(tokens.at(0).compare("bf_hash") == 0) {
+						bf_hash = tokens.at(1);
+					}
+
+					if(tokens.at(0).compare("tinylfu_width") == 0) {
+						tinylfu_width = atol(tokens.at(1).c_str());
+					}
+
+					if(tokens.at(0).compare("learned_admission_threshold") == 0) {
+						learned_admission_threshold = atof(tokens.at(1).c_str());
+					}
+
+					if(tokens.at(0).compare("learned_admission_window") == 0) {
+						learned_admission_window = atol(tokens.at(1).c_str());
+					}
+
+					if(tokens.at(0).compare("seed") == 0) {
+						seed = strtoull(tokens.at(1).c_str(), NULL, 10);
+					}
+
+					if(tokens.at(0).compare("cuckoo_slots") == 0) {
+						cuckoo_slots = atol(tokens.at(1).c_str());
+					}
+
+					if(tokens.at(0).compare("cuckoo_delete_on_admit") == 0) {
+						int value_ = atoi(tokens.at(1).c_str());
+						if (value_ == 1) {
+							cuckoo_delete_on_admit = true;
+						}
+					}
+
+					if(tokens.at(0).compare("eviction_samples") == 0) {
+						char* end;
+						long samples = strtol(tokens.at(1).c_str(), &end, 10);
+						if (*end != '\0' || samples < 1 || samples > UINT_MAX) {
+							cerr << "\neviction_samples must be 1 or more, got " << tokens.at(1) << ". Exiting.\n";
+							exit(1);
+						}
+						eviction_samples = samples;
+					}
+
+					if(tokens.at(0).compare("sample_scorer") == 0) {
+						sample_scorer = tokens.at(1);
+					}
+
+					if(tokens.at(0).compare("clock_bits") == 0) {
+						clock_bits = atoi(tokens.at(1).c_str());
+					}
+
+					if(tokens.at(0).compare("gdsf_cost") == 0) {
+						gdsf_cost = tokens.at(1);
+					}
+
+					if(tokens.at(0).compare("lirs_hir_share") == 0) {
+						lirs_hir_share = atof(tokens.at(1).c_str());
+					}
+
+					if(tokens.at(0).compare("lrb_window") == 0) {
+						lrb_window = atol(tokens.at(1).c_str());
+					}
+
+					if(tokens.at(0).compare("origin_cost") == 0) {
+						if (!parse_origin_cost(tokens.at(1), origin_cost)) {
+							cerr << "\nBad origin_cost entry in " << tokens.at(1) << ". Exiting.\n";
+							exit(1);
+						}
+					}
+
 					if(tokens.at(0).compare("regular_purge_interval") == 0) {
 						regular_purge_interval = atoi(tokens.at(1).c_str());
 					}
@@ -439,6 +655,13 @@ void EmConfItems::config_file_parser(string input_config_file) {
 						}
 					}
 
+					if(tokens.at(0).compare("customer_fair_eviction") == 0) {
+						int value_ = atoi(tokens.at(1).c_str());
+						if (value_ == 1) {
+							customer_fair_eviction = true;
+						}
+					}
+
 					if(tokens.at(0).compare("generate_bf_stats") == 0) {
 						int value_ = atoi(tokens.at(1).c_str());
 						if (value_ == 1) {
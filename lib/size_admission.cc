@@ -70,7 +70,7 @@ bool ProbAdmission::check(string key, unsigned long data, unsigned long long siz
     double r = 0.0;
 
     // Flip a coin check the number
-    r = ((double) rand() / (RAND_MAX));
+    r = rng.uniform();
 
     if (r < this->prob) {
         return true;
@@ -115,7 +115,7 @@ bool ProbSizeAdmission::check(string key, unsigned long data, unsigned long long
     prob = 1.0 / exp( d_size / (double)c);
 
     // Flip a coin check the number
-    r = ((double) rand() / (RAND_MAX));
+    r = rng.uniform();
 
     if (r < prob) {
         return true;
@@ -62,6 +62,8 @@ SizeLRUEviction::SizeLRUEviction(unsigned long long size, string id, const EmCon
     current_ingress_item_timestamp = 0;
 
     purge_size_based_limit = sci->LRU_list_size;
+    window_front = tail;
+    window_span = 0;
 
     cache_item_count = 0;
     max_cache_item_count = 0;
@@ -80,6 +82,10 @@ SizeLRUEviction::SizeLRUEviction(unsigned long long size, string id, const EmCon
 
     hour_count = 0;
 
+    if (sci->customer_fair_eviction) {
+        customer_recency.enable_fairness();
+    }
+
 }
 
 SizeLRUEviction::~SizeLRUEviction()
@@ -145,9 +151,7 @@ void SizeLRUEviction::hourly_purging(unsigned long timestamp) {
     // JUNK removal
     // its been X hours. remove small old files from the tail
     if (cache_filled_once == true && total_hourly_purge_intervals >= regular_purge_interval) {
-        // NOTE: As long as cistomer overrides are off, this should be too,
-        // saves time
-        //compute_periodic_stats(sci->floor_customer_loss);
+        // customer budgets and floor_customer_loss are refreshed from put()
         total_hourly_purge_intervals = 0;
         total_junk_purge_operations++;
 
@@ -166,8 +170,7 @@ void SizeLRUEviction::hourly_purging(unsigned long timestamp) {
     cout << endl << current_size << " " << total_capacity << endl;
     while (current_size > total_capacity * .80) {
         total_items_purged++;
-        purge_size_based_multimap();
-        //	purge_size_based(); // not used anymore, was too slow
+        purge_size_based();
     }
     cout << endl << "purge_size_based_call_count " << total_items_purged << endl;
 }
@@ -247,24 +250,10 @@ void SizeLRUEviction::print_oldest_file_age_for_monitored_customers(unsigned lon
     }
     cout << endl;
     for(vector<string>::const_iterator i = sci->monitor_customers_list.begin(); i != sci->monitor_customers_list.end(); ++i) {
-        SizeLRUEvictionEntry* currentNode = tail;
-        bool item_found = false;
-        for (currentNode = currentNode->prev; currentNode != head; currentNode = currentNode->prev) {
-            if(currentNode->customer_id.compare(*i) == 0) {
-                item_found = true;
-                cout << "print_oldest_file_age_days "
-                    << *i << " "
-                    << (float) (currentTimeStamp - currentNode->timestamp)/60/60/24 // days
-                    << "\n";
-                break;
-            }
-        }
-        if(!item_found) {
-            cout << "print_oldest_file_age_days "
-                << *i << " "
-                << 0
-                << "\n";
-        }
+        cout << "print_oldest_file_age_days "
+            << *i << " "
+            << customer_recency.oldest_age_days(*i, currentTimeStamp) // days
+            << "\n";
     }
     cout << endl;
 }
@@ -315,7 +304,16 @@ unsigned long long SizeLRUEviction::put(string key, unsigned long data, unsigned
             max_cache_item_count = cache_item_count;
         }
 
+        customer_recency.record_request(node, bytes_out, false);
+        if (customer_recency.update_budgets(timestamp, total_capacity, sci->floor_customer_loss)) {
+            // Protection is decided as entries join the window
+            reset_size_window();
+        }
+
         // Don't let it go over disk size!
+        if (sci->customer_fair_eviction) {
+            purge_customer_based();
+        }
         while (current_size > total_capacity) {
             purge_size_based_multimap();
             //  cerr << '#';
@@ -371,6 +369,7 @@ unsigned long SizeLRUEviction::get(string key, unsigned long ts, unsigned long b
         detach(node);
         attach(node);
         node->count = node->count + 1;
+        customer_recency.record_request(node, bytes_out, true);
 
         avg_oldest_requested_file_vector.push_back(node->timestamp);
 
@@ -749,6 +748,18 @@ void SizeLRUEviction::update_cost_based_score(SizeLRUEvictionEntry* node) {
 
 void SizeLRUEviction::detach(SizeLRUEvictionEntry* node)
 {
+    customer_recency.detach(node);
+    if (node->in_window) {
+        if (node->window_it != size_window.end()) {
+            size_window.erase(node->window_it);
+        }
+        if (node == window_front) {
+            window_front = node->next;
+        }
+        node->in_window = false;
+        --window_span;
+    }
+
     node->prev->next = node->next;
     node->next->prev = node->prev;
     current_size = current_size - node->data;
@@ -756,6 +767,8 @@ void SizeLRUEviction::detach(SizeLRUEvictionEntry* node)
 
 void SizeLRUEviction::attach(SizeLRUEvictionEntry* node)
 {
+    customer_recency.attach(node);
+    node->in_window = false;
     node->next = head->next;
     node->prev = head;
     head->next = node;
@@ -764,52 +777,78 @@ void SizeLRUEviction::attach(SizeLRUEvictionEntry* node)
 }
 
 void SizeLRUEviction::purge_size_based_multimap() {
-    if (cache_item_count < purge_size_based_limit) {
-        cerr << "cache_item_count " << cache_item_count
-            << ", is less than purge_size_based_limit " << purge_size_based_limit << endl;
-        cerr << "Setting purge_size_based_limit to half of cache_item_count." << endl;
-        purge_size_based_limit = cache_item_count / 2;
-    }
-
-    unsigned long total_items_purged = 0;
-    std::multimap<unsigned long, string> size_based_purge_list;
-
-    SizeLRUEvictionEntry* node = tail->prev;
-    size_based_purge_list.insert(std::pair<unsigned long, string>(node->data, node->key));
-
-    // populate the initial list
-    for(unsigned int i = 1; i < purge_size_based_limit; i++) {
-        node = node->prev;
-        //if (customer_hit_stats[node->customer_id]["skip_size_based_deletion"] != 1) {
-        // NOTE: For now, take it no matter what, don't worry about customer
-        size_based_purge_list.insert(std::pair<unsigned long, string>(node->data, node->key));
-        //    //	cout << "\nentry inserted " << node->key << " " << node->data << "\n";
-        //}
-    }
-
-    //cout << endl << "current_size  " << current_size << " " << total_capacity << endl;
-    //cout << "size_based_purge_list.size() " << size_based_purge_list.size() << endl;
-
-    while (current_size > total_capacity) {
-        std::multimap<unsigned long, string>::iterator it = (size_based_purge_list.end()); it--;
-        //cout << "\nitem_to_delete " << it->first << " " << it->second << endl;
-        SizeLRUEvictionEntry* node_to_delete = _mapping[it->second];
-
-        detach(node_to_delete);
-        _mapping.erase(node_to_delete->key);
-        delete node_to_delete;
-        size_based_purge_list.erase(it);
-        --cache_item_count;
-        total_items_purged++;
+    while (current_size > total_capacity && head->next != tail) {
+        purge_size_based();
+    }
+}
 
-        node = node->prev;
-        if (customer_hit_stats[node->customer_id]["skip_size_based_deletion"] != 1) {
-            size_based_purge_list.insert(std::pair<unsigned long, string>(node->data, node->key));
+/*
+ * The window is only ever grown from its head side, so an entry enters it at
+ * most once per trip down the LRU list and each eviction costs O(log N).
+ */
+void SizeLRUEviction::refill_size_window() {
+    while (window_span < purge_size_based_limit && window_front->prev != head) {
+        SizeLRUEvictionEntry* node = window_front->prev;
+        window_front = node;
+        node->in_window = true;
+        ++window_span;
+        if (skip_size_based_deletion(node->customer_id)) {
+            node->window_it = size_window.end();
+        }
+        else {
+            node->window_it = size_window.insert(
+                std::pair<unsigned long, SizeLRUEvictionEntry*>(node->data, node));
         }
+    }
+}
 
-        if (size_based_purge_list.size() <= 1) return;
+/* Empties the window, the next refill starts over from the tail */
+void SizeLRUEviction::reset_size_window() {
+    for (SizeLRUEvictionEntry* node = window_front; node != tail; node = node->next) {
+        node->in_window = false;
+    }
+    size_window.clear();
+    window_front = tail;
+    window_span = 0;
+}
+
+bool SizeLRUEviction::skip_size_based_deletion(const string& customer_id) {
+    return customer_recency.is_protected(customer_id);
+}
+
+void SizeLRUEviction::purge_size_based() {
+    refill_size_window();
+
+    // every covered customer is protected, fall back to plain LRU
+    if (size_window.empty()) {
+        purge_regular();
+        return;
+    }
+
+    std::multimap<unsigned long, SizeLRUEvictionEntry*>::iterator it = size_window.end(); it--;
+    evict(it->second);
+}
+
+void SizeLRUEviction::evict(SizeLRUEvictionEntry* node) {
+    detach(node);
+    _mapping.erase(node->key);
+    delete node;
+    --cache_item_count;
+}
+
+void SizeLRUEviction::purge_customer_based_approx() {
+    SizeLRUEvictionEntry* node = customer_recency.fair_victim();
+    if (node == NULL) {
+        purge_regular();
+        return;
+    }
+    evict(node);
+}
+
+void SizeLRUEviction::purge_customer_based() {
+    while (current_size > total_capacity && head->next != tail) {
+        purge_customer_based_approx();
     }
-    //cout << "total_items_purged by purge_size_based_multimap " << total_items_purged << endl;
 }
 
 string SizeLRUEviction::return_customer_id(string url) {
@@ -824,49 +863,6 @@ string SizeLRUEviction::return_customer_id(string url) {
     return v[3];
 }
 
-void SizeLRUEviction::compute_periodic_stats(bool floor_customer_loss) {
-	typedef std::unordered_map<string, unsigned long> inner_map;
-	typedef std::unordered_map<string, inner_map> outer_map;
-
-	for (outer_map::iterator i = customer_hit_stats.begin(), iend = customer_hit_stats.end(); i != iend; ++i)
-	{
-		// i->first = customer ID (e.g. 307A)
-		if (customer_hit_stats[i->first]["periodic_hits_and_misses"] > 0) {
-			unsigned long periodic_hit_ratio = 100 * (float) customer_hit_stats[i->first]["periodic_hits"]
-												   / (float) customer_hit_stats[i->first]["periodic_hits_and_misses"];
-			customer_hit_stats[i->first]["periodic_hit_ratio"] = periodic_hit_ratio;
-		}
-
-		if (customer_hit_stats[i->first]["periodic_bytes_hit_and_miss"] > 0) {
-			unsigned long periodic_byte_hit_ratio = 100 * (float) customer_hit_stats[i->first]["periodic_bytes_hit"]
-												   / (float) customer_hit_stats[i->first]["periodic_bytes_hit_and_miss"];
-
-			if (floor_customer_loss == true) {
-				int diff = periodic_byte_hit_ratio - customer_hit_stats[i->first]["periodic_byte_hit_ratio"];
-				if (diff > 100) {
-					cerr << "compute_periodic_stats(): diff > 100" << __LINE__ << " " << __FILE__;
-					exit(1);
-				}
-				else if (diff <= -2 && customer_hit_stats[i->first]["skip_size_based_deletion"] != 1) {
-					// the ratio reduced more than 2% since last time. so we need to protect the customer
-					customer_hit_stats[i->first]["skip_size_based_deletion"] = 1;
-				}
-				else if (diff >= 1 && customer_hit_stats[i->first]["skip_size_based_deletion"] != 0) {
-					// things got better, so no need to protect them.
-					customer_hit_stats[i->first]["skip_size_based_deletion"] = 0;
-				}
-			}
-
-			customer_hit_stats[i->first]["periodic_byte_hit_ratio"] = periodic_byte_hit_ratio;
-		}
-
-		customer_hit_stats[i->first]["periodic_hits"] = 0;
-		customer_hit_stats[i->first]["periodic_bytes_hit"] = 0;
-		customer_hit_stats[i->first]["periodic_hits_and_misses"] = 0;
-		customer_hit_stats[i->first]["periodic_bytes_hit_and_miss"] = 0;
-	}
-}
-
 void SizeLRUEviction::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
     double oldest_file_age;
 
@@ -881,4 +877,7 @@ void SizeLRUEviction::periodic_output(unsigned long ts, std::ostringstream& outl
     oldest_file_age = ((float) ts - tail->prev->timestamp)/60/60/24;
     outlogfile << oldest_file_age << " ";
 
+    // Monitored customers: oldest file age (days), bytes, objects
+    customer_recency.periodic_output(sci->monitor_customers_list, ts, outlogfile);
+
 }
@@ -0,0 +1,163 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+/*
+ * Hierarchical timer wheel, used for TTL expiry
+ *
+ */
+
+#include <stdlib.h>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <unordered_map>
+
+#include "em_structs.h"
+#include "cache_policy.h"
+#include "timer_wheel.h"
+
+using namespace std;
+
+TimerWheel::TimerWheel() {
+    for (int i = 0; i < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; i++) {
+        slots[i] = NULL;
+    }
+    for (int l = 0; l < TIMER_WHEEL_LEVELS; l++) {
+        level_count[l] = 0;
+    }
+    timer_count = 0;
+    current = 0;
+}
+
+void TimerWheel::schedule(FIFOEvictionEntry* node, unsigned long when) {
+    cancel(node);
+
+    // First timer ever, start the clock here instead of at 0
+    if (current == 0) {
+        current = when;
+    }
+
+    node->expires = when;
+    insert(node);
+    timer_count++;
+}
+
+void TimerWheel::cancel(FIFOEvictionEntry* node) {
+    if (node->timer_pprev == NULL) {
+        return;
+    }
+    unlink(node);
+    timer_count--;
+}
+
+unsigned long long TimerWheel::size() {
+    return timer_count;
+}
+
+/*
+ * Picks the level from the distance to the clock, the slot from the bits of
+ * the expiry time that belong to that level
+ */
+void TimerWheel::insert(FIFOEvictionEntry* node) {
+    unsigned long when = node->expires;
+    if (when < current) {
+        when = current;
+    }
+    unsigned long delta = when - current;
+
+    unsigned int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1
+           && delta >= (1UL << (TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    // Beyond the top level, park it in the furthest top level slot
+    if (level == TIMER_WHEEL_LEVELS - 1
+        && delta >= (1UL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))) {
+        when = current + (1UL << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    }
+
+    unsigned int slot = level * TIMER_WHEEL_SLOTS
+        + ((when >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+
+    node->timer_slot = slot;
+    node->timer_next = slots[slot];
+    if (node->timer_next) {
+        node->timer_next->timer_pprev = &node->timer_next;
+    }
+    node->timer_pprev = &slots[slot];
+    slots[slot] = node;
+    level_count[level]++;
+}
+
+void TimerWheel::unlink(FIFOEvictionEntry* node) {
+    *node->timer_pprev = node->timer_next;
+    if (node->timer_next) {
+        node->timer_next->timer_pprev = node->timer_pprev;
+    }
+    node->timer_next = NULL;
+    node->timer_pprev = NULL;
+    level_count[node->timer_slot / TIMER_WHEEL_SLOTS]--;
+}
+
+/*
+ * The current slot of 'level' is due, spread its timers over the levels below
+ */
+void TimerWheel::cascade(unsigned int level) {
+    unsigned int slot = level * TIMER_WHEEL_SLOTS
+        + ((current >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+
+    FIFOEvictionEntry* node = slots[slot];
+    slots[slot] = NULL;
+    while (node) {
+        FIFOEvictionEntry* next = node->timer_next;
+        level_count[level]--;
+        insert(node);
+        node = next;
+    }
+}
+
+void TimerWheel::advance(unsigned long now, vector<FIFOEvictionEntry*>& due) {
+    while (current <= now) {
+        if (timer_count == 0) {
+            current = now + 1;
+            break;
+        }
+
+        // Wrapped around, pull down the levels above (top one first)
+        if ((current & TIMER_WHEEL_MASK) == 0) {
+            unsigned int top = 1;
+            while (top < TIMER_WHEEL_LEVELS - 1
+                   && ((current >> (TIMER_WHEEL_BITS * top)) & TIMER_WHEEL_MASK) == 0) {
+                top++;
+            }
+            for (unsigned int level = top; level > 0; level--) {
+                cascade(level);
+            }
+        }
+
+        // Nothing can fire before level 0 wraps again
+        if (level_count[0] == 0) {
+            unsigned long next_wrap = (current | TIMER_WHEEL_MASK) + 1;
+            if (next_wrap > now) {
+                current = now + 1;
+                break;
+            }
+            current = next_wrap;
+            continue;
+        }
+
+        FIFOEvictionEntry* node = slots[current & TIMER_WHEEL_MASK];
+        slots[current & TIMER_WHEEL_MASK] = NULL;
+        while (node) {
+            FIFOEvictionEntry* next = node->timer_next;
+            level_count[0]--;
+            node->timer_next = NULL;
+            node->timer_pprev = NULL;
+            timer_count--;
+            due.push_back(node);
+            node = next;
+        }
+        current++;
+    }
+}
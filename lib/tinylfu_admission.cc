@@ -0,0 +1,186 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+/*
+ * TinyLFU Cache Admission Policy
+ *
+ */
+
+#include <algorithm>
+#include <string>
+#include <sstream>
+#include <utility>
+#include <vector>
+#include "hashfunc.h"
+#include "cache_policy.h"
+#include "tinylfu_admission.h"
+
+using namespace std;
+
+TinyLFUAdmission::TinyLFUAdmission(CacheEviction* eviction, unsigned long width,
+                                   vector<string> no_bf_cust) {
+    name = "tinylfu";
+    this->eviction = eviction;
+    this->no_bf_cust = no_bf_cust;
+
+    // a power of 2, at least one word per row
+    this->width = 16;
+    while (this->width < width) {
+        this->width <<= 1;
+    }
+    sketch.assign(TINYLFU_ROWS * this->width / 16, 0);
+    door.assign(this->width * TINYLFU_DOOR_BITS / 64, 0);
+    door_mask = this->width * TINYLFU_DOOR_BITS - 1;
+
+    additions = 0;
+    sample_size = (unsigned long long) TINYLFU_SAMPLE_FACTOR * this->width;
+
+    admitted = 0;
+    rejected = 0;
+    free_admits = 0;
+    resets = 0;
+}
+
+TinyLFUAdmission::~TinyLFUAdmission() {
+}
+
+void TinyLFUAdmission::hash(const string& key, uint64_t& h1, uint64_t& h2) {
+    h1 = wyhash(key.data(), key.size(), TINYLFU_HASH_SEED);
+    h2 = fmix64(h1) | 1;
+}
+
+bool TinyLFUAdmission::door_contains(uint64_t h1, uint64_t h2) {
+    uint64_t a = h1 & door_mask;
+    uint64_t b = (h1 + h2) & door_mask;
+    return ((door[a >> 6] >> (a & 63)) & 1) && ((door[b >> 6] >> (b & 63)) & 1);
+}
+
+void TinyLFUAdmission::door_put(uint64_t h1, uint64_t h2) {
+    uint64_t a = h1 & door_mask;
+    uint64_t b = (h1 + h2) & door_mask;
+    door[a >> 6] |= 1ULL << (a & 63);
+    door[b >> 6] |= 1ULL << (b & 63);
+}
+
+/* Halve every counter (the shift can't carry across nibbles after the mask) */
+void TinyLFUAdmission::reset() {
+    for (size_t i = 0; i < sketch.size(); i++) {
+        sketch[i] = (sketch[i] >> 1) & 0x7777777777777777ULL;
+    }
+    fill(door.begin(), door.end(), 0);
+    additions /= 2;
+    resets++;
+}
+
+void TinyLFUAdmission::record(const string& key) {
+    uint64_t h1, h2;
+    hash(key, h1, h2);
+
+    if (!door_contains(h1, h2)) {
+        door_put(h1, h2);
+    }
+    else {
+        // conservative update, only the smallest counters go up
+        unsigned int min_count = TINYLFU_COUNTER_MAX;
+        for (unsigned int r = 0; r < TINYLFU_ROWS; r++) {
+            min_count = min(min_count, counter(r, row_index(h1, h2, r)));
+        }
+        if (min_count < TINYLFU_COUNTER_MAX) {
+            for (unsigned int r = 0; r < TINYLFU_ROWS; r++) {
+                uint64_t i = row_index(h1, h2, r);
+                if (counter(r, i) == min_count) {
+                    increment(r, i);
+                }
+            }
+        }
+    }
+
+    if (++additions >= sample_size) {
+        reset();
+    }
+}
+
+unsigned int TinyLFUAdmission::estimate(const string& key) {
+    uint64_t h1, h2;
+    hash(key, h1, h2);
+
+    unsigned int min_count = TINYLFU_COUNTER_MAX;
+    for (unsigned int r = 0; r < TINYLFU_ROWS; r++) {
+        min_count = min(min_count, counter(r, row_index(h1, h2, r)));
+    }
+    return min_count + (door_contains(h1, h2) ? 1 : 0);
+}
+
+// Should we let this in?
+bool TinyLFUAdmission::check(string key, unsigned long data, unsigned long long size,
+                             unsigned long ts, string customer_id_str) {
+    record(key);
+
+    // Check to see if this customer bypasses the filter. If so, just let
+    // it in
+    if (check_customer_in_list(customer_id_str)) {
+        return true;
+    }
+
+    unsigned int candidate = estimate(key);
+    if (!eviction->peek_victims(size, TINYLFU_MAX_VICTIMS, victims)) {
+        // No victim to compare with, act as second-hit
+        if (candidate >= 2) {
+            admitted++;
+            return true;
+        }
+        rejected++;
+        return false;
+    }
+
+    if (victims.empty()) {
+        free_admits++;
+        return true;
+    }
+
+    // Byte weighted frequency of what would be pushed out
+    double victim_freq = 0;
+    double victim_bytes = 0;
+    for (size_t i = 0; i < victims.size(); i++) {
+        victim_freq += (double) estimate(victims[i].first) * victims[i].second;
+        victim_bytes += victims[i].second;
+    }
+    if (victim_bytes > 0) {
+        victim_freq /= victim_bytes;
+    }
+
+    if (candidate > victim_freq) {
+        admitted++;
+        return true;
+    }
+    rejected++;
+    return false;
+}
+
+void TinyLFUAdmission::record_hit(const string& key, unsigned long long size,
+                                  unsigned long ts, const string& customer_id_str) {
+    record(key);
+}
+
+bool TinyLFUAdmission::check_customer_in_list(string custid) const{
+    if(std::find(no_bf_cust.begin(), no_bf_cust.end(), custid) != no_bf_cust.end())
+        return true;
+    else
+        return false;
+}
+
+void TinyLFUAdmission::periodic_output(unsigned long ts, std::ostringstream& outlogfile){
+    outlogfile << " : " << name << " ";
+
+    outlogfile << admitted << " "
+        << rejected << " "
+        << free_admits << " "
+        << resets << " "
+        << (sketch.size() + door.size()) * sizeof(uint64_t) / 1024 << " ";
+
+    admitted = 0;
+    rejected = 0;
+    free_admits = 0;
+    resets = 0;
+}
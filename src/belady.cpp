@@ -0,0 +1,59 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+// Emulator stuff we will always need
+#include "em_structs.h"
+#include "emulator.h"
+#include "cache.h"
+#include "next_access.h"
+
+// The specific policies we will consider
+#include "null_admission.h"
+#include "belady_eviction.h"
+
+using namespace std;
+/*
+ * Belady eviction, admitting everything. Offline: reads the whole trace
+ * first to know each request's next access, then replays it.
+ */
+int main(int argc, char *argv[]) {
+
+    cout << "\nExecutable: \t" << argv[0] << "\n";
+
+    Emulator* em = new Emulator(cout, false, argc, argv);
+
+    unsigned long long hd_max_size_gig = em->sci->hd_gig;
+    unsigned long long hd_max_size_bytes = hd_max_size_gig *1024*1024*1024;
+
+    // Let's make a hard drive
+    Cache* hd = new Cache(0, false, false, hd_max_size_gig);
+    NullAdmission* hd_ad = new NullAdmission();
+    CacheEviction* hd_evict = new BeladyEviction(hd_max_size_bytes, "h", em->sci);
+    hd->set_admission(hd_ad);
+    hd->set_eviction(hd_evict);
+
+    em->add_to_tail(hd);
+
+    NextAccessOracle* oracle = new NextAccessOracle();
+    oracle->annotate(cin, em);
+    em->set_next_access_oracle(oracle);
+
+    // Run it
+    /**************************/
+    em->populate_access_log_cache(oracle->trace());
+    /**************************/
+
+    delete hd;
+    delete hd_ad;
+    delete hd_evict;
+
+    delete em;
+    delete oracle;
+
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+// Emulator stuff we will always need
+#include "em_structs.h"
+#include "emulator.h"
+#include "cache.h"
+
+// The specific policies we will consider
+#include "second_hit_admission.h"
+#include "gdsf_eviction.h"
+
+using namespace std;
+/*
+ * Second-hit caching in front of GreedyDual-Size-Frequency eviction, the cost
+ * comes from gdsf_cost (-W) and origin_cost (-O).
+ */
+int main(int argc, char *argv[]) {
+
+    cout << "\nExecutable: \t" << argv[0] << "\n";
+
+    Emulator* em = new Emulator(cout, false, argc, argv);
+
+    // Some random seeding work
+    srand(em->sci->seed);
+    ostringstream ossf;
+    ossf << rand();
+
+    unsigned long long hd_max_size_gig = em->sci->hd_gig;
+    unsigned long long hd_max_size_bytes = hd_max_size_gig *1024*1024*1024;
+
+    string hd_file_name = string(ossf.str() + ".bf");
+
+    // Let's make a hard drive
+    Cache* hd = new Cache(0, false, false, hd_max_size_gig);
+    SecondHitAdmissionRot* hd_ad = new SecondHitAdmissionRot(hd_file_name, 5,
+                                                   50*1024*1024*8,
+                                                   em->sci->_NVAL,//2nd hit
+                                                   em->sci->no_bf_cust,
+                                                   em->sci->bf_reset_int,
+                                                   em->sci->bf_generations);
+    hd_ad->set_hash(em->sci->bf_hash);
+    hd_ad->set_customer_nval(&em->sci->customer_nval);
+    CacheEviction* hd_evict = new GDSFEviction(hd_max_size_bytes, "h", em->sci);
+    hd->set_admission(hd_ad);
+    hd->set_eviction(hd_evict);
+
+    em->add_to_tail(hd);
+
+    // Run it
+    /**************************/
+    em->populate_access_log_cache();
+    /**************************/
+
+    delete hd;
+    delete hd_ad;
+    delete hd_evict;
+
+    delete em;
+
+    return 0;
+}
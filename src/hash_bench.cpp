@@ -0,0 +1,152 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <math.h>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include "hashfunc.h"
+#include "bloomfilter.h"
+
+using namespace std;
+
+/*
+ * Hash speed and quality on trace URLs
+ *
+ * Reads a request log on stdin (same format as the emulators) and for every
+ * hash in hashfunc.h's hash_family reports hashing throughput, 64 bit
+ * collisions and the false positive rate of a BloomFilter using it. Half of
+ * the distinct URLs go into the filter, the other half are looked up.
+ *
+ *   -n  distinct URLs to use (default 1000000)
+ *   -b  filter bits per inserted URL (default 10)
+ *   -k  hash functions (default 5, as the 2hc filters)
+ *   -r  timing rounds over all URLs (default 5)
+ */
+
+static double hash_seconds(hash64_fn fn, const vector<string>& urls, int rounds, uint64_t& sink) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < urls.size(); i++) {
+            sink += fn(urls[i].data(), urls[i].size(), r);
+        }
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static unsigned long collisions(hash64_fn fn, const vector<string>& urls) {
+    unordered_set<uint64_t> seen;
+    seen.reserve(urls.size());
+    unsigned long c = 0;
+    for (size_t i = 0; i < urls.size(); i++) {
+        if (!seen.insert(fn(urls[i].data(), urls[i].size(), 0)).second) {
+            c++;
+        }
+    }
+    return c;
+}
+
+/* Percent of the second half of urls the filter wrongly reports present */
+static double bloom_fpr(hash64_fn fn, const vector<string>& urls, unsigned long bits, size_t nfuncs) {
+    BloomFilter bf("", nfuncs, bits, 1);
+    bf.set_hash(fn);
+    size_t half = urls.size() / 2;
+    for (size_t i = 0; i < half; i++) {
+        bf.add((char *) urls[i].c_str());
+    }
+    unsigned long fp = 0;
+    for (size_t i = half; i < urls.size(); i++) {
+        if (bf.check((char *) urls[i].c_str())) {
+            fp++;
+        }
+    }
+    return 100.0 * fp / (urls.size() - half);
+}
+
+int main(int argc, char *argv[]) {
+
+    cout << "\nExecutable: \t" << argv[0] << "\n";
+
+    unsigned long max_urls = 1000000;
+    double bits_per_url = 10;
+    size_t nfuncs = 5;
+    int rounds = 5;
+
+    int c;
+    while ((c = getopt (argc, argv, "n:b:k:r:")) != -1)
+        switch (c)
+        {
+            case 'n':
+                max_urls = atol(optarg);
+                break;
+            case 'b':
+                bits_per_url = atof(optarg);
+                break;
+            case 'k':
+                nfuncs = atoi(optarg);
+                break;
+            case 'r':
+                rounds = atoi(optarg);
+                break;
+            default:
+                abort ();
+        }
+
+    // The URL is the last column of a request line
+    vector<string> urls;
+    unordered_set<string> distinct;
+    unsigned long long total_bytes = 0;
+    string line;
+    while (urls.size() < max_urls && getline(cin, line)) {
+        size_t pos = line.find_last_of(' ');
+        string url = (pos == string::npos) ? line : line.substr(pos + 1);
+        if (url.empty() || !distinct.insert(url).second) {
+            continue;
+        }
+        total_bytes += url.size();
+        urls.push_back(url);
+    }
+    distinct.clear();
+    if (urls.size() < 2) {
+        cerr << "\nNeed at least 2 distinct URLs on stdin. Exiting.\n";
+        exit(1);
+    }
+
+    unsigned long bits = (unsigned long) (bits_per_url * (urls.size() / 2));
+    double theory = 100 * pow(1 - exp(-1.0 * nfuncs / bits_per_url), nfuncs);
+
+    cout << urls.size() << " distinct URLs, " << (double) total_bytes / urls.size()
+        << " bytes on average, " << bits_per_url << " bits per URL, " << nfuncs
+        << " hash functions, theoretical FPR " << theory << "%\n\n";
+
+    cout << setw(12) << "hash" << setw(12) << "MB/s" << setw(12) << "ns/url"
+        << setw(14) << "collisions" << setw(12) << "bloom_fpr%" << endl;
+
+    uint64_t sink = 0;
+    for (size_t h = 0; h < HASH_FAMILY_SIZE; h++) {
+        hash64_fn fn = hash_family[h].fn;
+        double secs = hash_seconds(fn, urls, rounds, sink);
+        cout << setw(12) << hash_family[h].name
+            << setw(12) << (double) total_bytes * rounds / secs / 1024 / 1024
+            << setw(12) << secs * 1e9 / ((double) urls.size() * rounds)
+            << setw(14) << collisions(fn, urls)
+            << setw(12) << bloom_fpr(fn, urls, bits, nfuncs) << endl;
+    }
+
+    // What the admission filters use by default: a separate bkdr per function
+    cout << setw(12) << "bkdr_ind" << setw(12) << "-" << setw(12) << "-"
+        << setw(14) << "-" << setw(12) << bloom_fpr(NULL, urls, bits, nfuncs) << endl;
+
+    // Keep the hashing loops from being optimized away
+    cerr << "checksum " << sink << endl;
+
+    return 0;
+}
@@ -29,7 +29,7 @@ int main(int argc, char *argv[]) {
     Emulator* em = new Emulator(cout, false, argc, argv);
 
     // Some random seeding work
-    srand(time(NULL));
+    srand(em->sci->seed);
     ostringstream ossf;
     ossf << rand();
 
@@ -57,11 +57,14 @@ int main(int argc, char *argv[]) {
 
     // Let's make a hard drive
     Cache* hd = new Cache(0, false, false, hd_max_size_gig);
-    CacheAdmission* hd_ad = new SecondHitAdmissionRot(hd_file_name, 5,
+    SecondHitAdmissionRot* hd_ad = new SecondHitAdmissionRot(hd_file_name, 5,
                                                    50*1024*1024*8,
                                                    em->sci->_NVAL,//2nd hit
                                                    em->sci->no_bf_cust,
-                                                   em->sci->bf_reset_int);
+                                                   em->sci->bf_reset_int,
+                                                   em->sci->bf_generations);
+    hd_ad->set_hash(em->sci->bf_hash);
+    hd_ad->set_customer_nval(&em->sci->customer_nval);
     //CacheAdmission* hd_ad = new NullAdmission();
     CacheEviction* hd_evict = new LRUEviction(hd_max_size_bytes, "h", em->sci);
     hd->set_admission(hd_ad);
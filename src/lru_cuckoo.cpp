@@ -0,0 +1,58 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+// Emulator stuff we will always need
+#include "em_structs.h"
+#include "emulator.h"
+#include "cache.h"
+
+// The specific policies we will consider
+#include "cuckoo_admission.h"
+#include "lru_eviction.h"
+
+using namespace std;
+/*
+ * N-hit caching (-N) with a cuckoo filter in front of LRU. Keys age out after
+ * about twice -R seconds. -C sets the filter size in slots, -D removes a key
+ * from the filter once it is admitted.
+ */
+int main(int argc, char *argv[]) {
+
+    cout << "\nExecutable: \t" << argv[0] << "\n";
+
+    Emulator* em = new Emulator(cout, false, argc, argv);
+
+    unsigned long long hd_max_size_gig = em->sci->hd_gig;
+    unsigned long long hd_max_size_bytes = hd_max_size_gig *1024*1024*1024;
+
+    // Let's make a hard drive
+    Cache* hd = new Cache(0, false, false, hd_max_size_gig);
+    CacheAdmission* hd_ad = new CuckooAdmission(em->sci->cuckoo_slots,
+                                                em->sci->_NVAL,
+                                                em->sci->no_bf_cust,
+                                                2 * em->sci->bf_reset_int,
+                                                em->sci->cuckoo_delete_on_admit);
+    CacheEviction* hd_evict = new LRUEviction(hd_max_size_bytes, "h", em->sci);
+    hd->set_admission(hd_ad);
+    hd->set_eviction(hd_evict);
+
+    em->add_to_tail(hd);
+
+    // Run it
+    /**************************/
+    em->populate_access_log_cache();
+    /**************************/
+
+    delete hd;
+    delete hd_ad;
+    delete hd_evict;
+
+    delete em;
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+// Emulator stuff we will always need
+#include "em_structs.h"
+#include "emulator.h"
+#include "cache.h"
+
+// The specific policies we will consider
+#include "combined_admission.h"
+#include "null_admission.h"
+#include "second_hit_admission.h"
+#include "lru_eviction.h"
+
+using namespace std;
+/*
+ * Second-hit caching in front of LRU, built from admission combinators:
+ *
+ *   or(customer_gate(no_bf_cust, null), size_gate(size < -S, 2hc_rot))
+ *
+ * Customers in disable_bf_per_customer are admitted without a filter probe,
+ * objects of -S bytes or more are rejected before the filter is probed.
+ */
+int main(int argc, char *argv[]) {
+
+    cout << "\nExecutable: \t" << argv[0] << "\n";
+
+    Emulator* em = new Emulator(cout, false, argc, argv);
+
+    // Some random seeding work
+    srand(em->sci->seed);
+    ostringstream ossf;
+    ossf << rand();
+
+    unsigned long long hd_max_size_gig = em->sci->hd_gig;
+    unsigned long long hd_max_size_bytes = hd_max_size_gig *1024*1024*1024;
+
+    string hd_file_name = string(ossf.str() + ".bf");
+
+    // Let's make a hard drive
+    Cache* hd = new Cache(0, false, false, hd_max_size_gig);
+    SecondHitAdmissionRot* hd_2hc = new SecondHitAdmissionRot(hd_file_name, 5,
+                                                   50*1024*1024*8,
+                                                   em->sci->_NVAL,//2nd hit
+                                                   vector<string>(), // bypass is the customer gate's
+                                                   em->sci->bf_reset_int,
+                                                   em->sci->bf_generations);
+    hd_2hc->set_hash(em->sci->bf_hash);
+    hd_2hc->set_customer_nval(&em->sci->customer_nval);
+
+    // The root owns the whole tree
+    CacheAdmission* hd_ad = new OrAdmission(
+            new CustomerGatedAdmission(em->sci->no_bf_cust, new NullAdmission(), false),
+            new SizeGatedAdmission(0, em->sci->admission_size, hd_2hc, false));
+    CacheEviction* hd_evict = new LRUEviction(hd_max_size_bytes, "h", em->sci);
+    hd->set_admission(hd_ad);
+    hd->set_eviction(hd_evict);
+
+    em->add_to_tail(hd);
+
+    // Run it
+    /**************************/
+    em->populate_access_log_cache();
+    /**************************/
+
+    delete hd;
+    delete hd_ad;
+    delete hd_evict;
+
+    delete em;
+
+    return 0;
+}
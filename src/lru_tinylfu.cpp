@@ -0,0 +1,56 @@
+// Copyright 2021 Edgio Inc
+// Licensed under the terms of the Apache 2.0 open source license
+// See LICENSE file for terms.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+// Emulator stuff we will always need
+#include "em_structs.h"
+#include "emulator.h"
+#include "cache.h"
+
+// The specific policies we will consider
+#include "tinylfu_admission.h"
+#include "lru_eviction.h"
+
+using namespace std;
+/*
+ * TinyLFU admission in front of LRU: once the disk is full a miss only gets
+ * in if it was requested more often than what it would push out. -L sets
+ * the sketch width (about the number of objects tracked).
+ */
+int main(int argc, char *argv[]) {
+
+    cout << "\nExecutable: \t" << argv[0] << "\n";
+
+    Emulator* em = new Emulator(cout, false, argc, argv);
+
+    unsigned long long hd_max_size_gig = em->sci->hd_gig;
+    unsigned long long hd_max_size_bytes = hd_max_size_gig *1024*1024*1024;
+
+    // Let's make a hard drive, the admission looks at the eviction's victims
+    Cache* hd = new Cache(0, false, false, hd_max_size_gig);
+    CacheEviction* hd_evict = new LRUEviction(hd_max_size_bytes, "h", em->sci);
+    CacheAdmission* hd_ad = new TinyLFUAdmission(hd_evict,
+                                                 em->sci->tinylfu_width,
+                                                 em->sci->no_bf_cust);
+    hd->set_admission(hd_ad);
+    hd->set_eviction(hd_evict);
+
+    em->add_to_tail(hd);
+
+    // Run it
+    /**************************/
+    em->populate_access_log_cache();
+    /**************************/
+
+    delete hd;
+    delete hd_ad;
+    delete hd_evict;
+
+    delete em;
+
+    return 0;
+}